@@ -47,17 +47,24 @@ void Dattorro1997Tank::process(const float leftIn, const float rightIn,
     tickApfModulation();
 
     //decay = frozen ? 1. : decayParam;
-    decay = decayParam;
+    if (decayRamp.moving()) {
+        decay = decayRamp.next();
+    }
+
+    // While freezing, fade takes the input out, the damping filters out
+    // and the loop gain up to 1, so that the tank arrives at exactly the
+    // state processFrozen() keeps running
+    const float loopGain = decay + (1. - decay) * (1. - fade);
 
-    leftSum += leftIn;
-    rightSum += rightIn;
+    leftSum += leftIn * fade;
+    rightSum += rightIn * fade;
 
     leftApf1.input = leftSum;
     leftDelay1.input = leftApf1.process();
     leftDelay1.process();
     leftHighCutFilter.input = leftDelay1.output;
     leftLowCutFilter.input = leftHighCutFilter.process();
-    leftApf2.input = (leftDelay1.output * (1. - fade) + leftLowCutFilter.process() * fade) * decay;
+    leftApf2.input = (leftDelay1.output * (1. - fade) + leftLowCutFilter.process() * fade) * loopGain;
     leftDelay2.input = leftApf2.process();
     leftDelay2.process();
 
@@ -66,13 +73,67 @@ void Dattorro1997Tank::process(const float leftIn, const float rightIn,
     rightDelay1.process();
     rightHighCutFilter.input = rightDelay1.output;
     rightLowCutFilter.input =  rightHighCutFilter.process();
-    rightApf2.input = (rightDelay1.output * (1. - fade) + rightLowCutFilter.process() * fade) * decay;
+    rightApf2.input = (rightDelay1.output * (1. - fade) + rightLowCutFilter.process() * fade) * loopGain;
     rightDelay2.input = rightApf2.process();
     rightDelay2.process();
 
-    rightSum = leftDelay2.output * decay;
-    leftSum = rightDelay2.output * decay;
+    rightSum = leftDelay2.output * loopGain;
+    leftSum = rightDelay2.output * loopGain;
+
+    processOutputTaps(leftOut, rightOut);
+
+    fade += fadeStep * fadeDir;
+    fade = (fade < 0.) ? 0. : ((fade > 1.) ? 1. : fade);
+}
+
+// Frozen tank: only the loop allpasses and delays, at unity gain, with no
+// input, damping or modulation. The allpasses are lossless, and the delays
+// are rounded to whole samples so they don't interpolate, so the tail
+// sustains without building up or dulling.
+void Dattorro1997Tank::processFrozen(float* leftOut, float* rightOut) {
+    if (!loopRounded) {
+        roundLoopDelayTimes();
+        loopRounded = true;
+    }
+
+    leftApf1.input = leftSum;
+    leftDelay1.input = leftApf1.process();
+    leftDelay1.process();
+    leftApf2.input = leftDelay1.output;
+    leftDelay2.input = leftApf2.process();
+    leftDelay2.process();
 
+    rightApf1.input = rightSum;
+    rightDelay1.input = rightApf1.process();
+    rightDelay1.process();
+    rightApf2.input = rightDelay1.output;
+    rightDelay2.input = rightApf2.process();
+    rightDelay2.process();
+
+    rightSum = leftDelay2.output;
+    leftSum = rightDelay2.output;
+
+    processOutputTaps(leftOut, rightOut);
+}
+
+// Moves each loop delay by at most half a sample. The allpasses keep the
+// last time their modulation gave them.
+void Dattorro1997Tank::roundLoopDelayTimes() {
+    leftApf1.delay.roundDelayTime();
+    leftDelay1.roundDelayTime();
+    leftApf2.delay.roundDelayTime();
+    leftDelay2.roundDelayTime();
+    rightApf1.delay.roundDelayTime();
+    rightDelay1.roundDelayTime();
+    rightApf2.delay.roundDelayTime();
+    rightDelay2.roundDelayTime();
+}
+
+bool Dattorro1997Tank::isFrozen() const {
+    return frozen && fade <= 0.;
+}
+
+void Dattorro1997Tank::processOutputTaps(float* leftOut, float* rightOut) {
     leftOutDCBlock.input = leftApf1.output;
     leftOutDCBlock.input += leftDelay1.tap(scaledOutputTaps[L_DELAY_1_L_TAP_1]);
     leftOutDCBlock.input += leftDelay1.tap(scaledOutputTaps[L_DELAY_1_L_TAP_2]);
@@ -93,9 +154,6 @@ void Dattorro1997Tank::process(const float leftIn, const float rightIn,
 
     *leftOut = leftOutDCBlock.process() * 0.5;
     *rightOut = rightOutDCBlock.process() * 0.5;
-
-    fade += fadeStep * fadeDir;
-    fade = (fade < 0.) ? 0. : ((fade > 1.) ? 1. : fade);
 }
 
 void Dattorro1997Tank::freeze(bool freezeFlag) {
@@ -107,6 +165,13 @@ void Dattorro1997Tank::freeze(bool freezeFlag) {
     else {
         fadeDir = 1.;
         //decay = decayParam;
+
+        // Back to the exact delay times; process() sets the allpasses'
+        // from their modulation again
+        if (loopRounded) {
+            rescaleApfAndDelayTimes();
+            loopRounded = false;
+        }
     }
 }
 
@@ -116,7 +181,7 @@ void Dattorro1997Tank::setSampleRate(const float newSampleRate) {
     sampleRate = sampleRate < 1. ? 1. : sampleRate;
     sampleRateScale = sampleRate / dattorroSampleRate;
 
-    fadeStep = 1. / sampleRate;
+    fadeStep = 1. / (fadeTime * sampleRate);
 
     leftOutDCBlock.setSampleRate(sampleRate);
     rightOutDCBlock.setSampleRate(sampleRate);
@@ -134,6 +199,9 @@ void Dattorro1997Tank::setTimeScale(const float newTimeScale) {
     timeScale = newTimeScale < 0.0001 ? 0.0001 : newTimeScale;
 
     rescaleApfAndDelayTimes();
+    if (loopRounded) {
+        roundLoopDelayTimes();
+    }
 }
 
 #pragma GCC pop_options
@@ -141,9 +209,14 @@ void Dattorro1997Tank::setTimeScale(const float newTimeScale) {
 void Dattorro1997Tank::setDecay(const float newDecay) {
     decayParam = (float)(newDecay > 1. ? 1. :
                          (newDecay < 0. ? 0. : newDecay));
+    decayRamp.set(decayParam);
 }
 
 void Dattorro1997Tank::setModSpeed(const float newModSpeed) {
+    if (newModSpeed == modSpeed) {
+        return;
+    }
+    modSpeed = newModSpeed;
     lfo1.setFrequency(lfo1Freq * newModSpeed);
     lfo2.setFrequency(lfo2Freq * newModSpeed);
     lfo3.setFrequency(lfo3Freq * newModSpeed);
@@ -152,7 +225,7 @@ void Dattorro1997Tank::setModSpeed(const float newModSpeed) {
 
 void Dattorro1997Tank::setModDepth(const float newModDepth) {
     modDepth = newModDepth;
-    lfoExcursion = newModDepth * lfoMaxExcursion * sampleRateScale;
+    lfoExcursionRamp.set(newModDepth * lfoMaxExcursion * sampleRateScale);
 }
 
 void Dattorro1997Tank::setModShape(const float shape) {
@@ -192,6 +265,11 @@ void Dattorro1997Tank::setDiffusion(const float diffusion) {
     rightApf2.setGain(diffusion);
 }
 
+void Dattorro1997Tank::setParameterRampLength(int samples) {
+    decayRamp.setLength(samples);
+    lfoExcursionRamp.setLength(samples);
+}
+
 void Dattorro1997Tank::clear() {
     leftApf1.clear();
     leftDelay1.clear();
@@ -252,6 +330,9 @@ void Dattorro1997Tank::initialiseDelaysAndApfs() {
 }
 
 void Dattorro1997Tank::tickApfModulation() {
+    if (lfoExcursionRamp.moving()) {
+        lfoExcursion = lfoExcursionRamp.next();
+    }
     leftApf1.delay.setDelayTime(lfo1.process() * lfoExcursion + scaledLeftApf1Time);
     leftApf2.delay.setDelayTime(lfo2.process() * lfoExcursion + scaledLeftApf2Time);
     rightApf1.delay.setDelayTime(lfo3.process() * lfoExcursion + scaledRightApf1Time);
@@ -308,6 +389,10 @@ Dattorro::Dattorro(const float initMaxSampleRate,
 
     inputLpf = OnePoleLPFilter(22000.0);
     inputHpf = OnePoleHPFilter(0.0);
+    inputHighCutRamp.jump(inputHighCut);
+    inputLowCutRamp.jump(inputLowCut);
+    inputLpf.setCutoffFreq(inputHighCut);
+    inputHpf.setCutoffFreq(inputLowCut);
 
     inApf1 = AllpassFilter(dattorroScale(8 * kInApf1Time), dattorroScale(kInApf1Time), inputDiffusion1);
     inApf2 = AllpassFilter(dattorroScale(8 * kInApf2Time), dattorroScale(kInApf2Time), inputDiffusion1);
@@ -332,13 +417,28 @@ Dattorro::Dattorro(const float initMaxSampleRate,
 //float subApfOut = 0.;
 
 void Dattorro::process(float leftInput, float rightInput) {
+    // Once the tank is fully frozen nothing reaches it, so the input
+    // chain is skipped as well
+    if (tank.isFrozen()) {
+        tank.processFrozen(&leftOut, &rightOut);
+        inputSkipped = true;
+        return;
+    }
+
+    if (inputHighCutRamp.moving()) {
+        inputLpf.setCutoffFreq(inputHighCutRamp.next());
+    }
+    if (inputLowCutRamp.moving()) {
+        inputHpf.setCutoffFreq(inputLowCutRamp.next());
+    }
     leftInputDCBlock.input = leftInput;
     rightInputDCBlock.input = rightInput;
-    inputLpf.setCutoffFreq(inputHighCut);
-    inputHpf.setCutoffFreq(inputLowCut);
     inputLpf.input = leftInputDCBlock.process() + rightInputDCBlock.process();
     inputHpf.input = inputLpf.process();
     inputHpf.process();
+    if (preDelayRamp.moving()) {
+        preDelay.setDelayTime(preDelayRamp.next());
+    }
     preDelay.input = inputHpf.output;
     preDelay.process();
     inApf1.input = preDelay.output;
@@ -351,6 +451,11 @@ void Dattorro::process(float leftInput, float rightInput) {
 }
 
 void Dattorro::clear() {
+    clearInput();
+    tank.clear();
+}
+
+void Dattorro::clearInput() {
     leftInputDCBlock.clear();
     rightInputDCBlock.clear();
 
@@ -361,8 +466,6 @@ void Dattorro::clear() {
     inApf2.clear();
     inApf3.clear();
     inApf4.clear();
-
-    tank.clear();
 }
 
 #pragma GCC push_options
@@ -383,7 +486,8 @@ void Dattorro::setTimeScale(float timeScale) {
 #pragma GCC optimize ("Ofast")
 
 void Dattorro::setPreDelay(float t) {
-    preDelay.setDelayTime(t * sampleRate);
+    preDelayTime = t;
+    preDelayRamp.set(t * sampleRate);
 }
 
 // void Dattorro::setPreDelay(float t) {
@@ -396,7 +500,8 @@ void Dattorro::setSampleRate(float newSampleRate) {
     sampleRate = newSampleRate;
     tank.setSampleRate(sampleRate);
     dattorroScaleFactor = sampleRate / dattorroSampleRate;
-    setPreDelay(preDelayTime);
+    preDelayRamp.jump(preDelayTime * sampleRate);
+    preDelay.setDelayTime(preDelayRamp.getValue());
     inApf1.delay.setDelayTime(dattorroScale(kInApf1Time));
     inApf2.delay.setDelayTime(dattorroScale(kInApf2Time));
     inApf3.delay.setDelayTime(dattorroScale(kInApf3Time));
@@ -406,12 +511,24 @@ void Dattorro::setSampleRate(float newSampleRate) {
     rightInputDCBlock.setSampleRate(sampleRate);
     inputLpf.setSampleRate(sampleRate);
     inputHpf.setSampleRate(sampleRate);
+    inputHighCutRamp.jump(inputHighCut);
+    inputLowCutRamp.jump(inputLowCut);
+    inputLpf.setCutoffFreq(inputHighCut);
+    inputHpf.setCutoffFreq(inputLowCut);
 
     //clear();
 }
 
 void Dattorro::freeze(bool freezeFlag) {
     tank.freeze(freezeFlag);
+
+    // The input chain stopped while the tank was frozen, so the pre-delay
+    // and diffusers still hold audio from before the freeze. Start them
+    // from silence rather than replay it into the tank.
+    if (!freezeFlag && inputSkipped) {
+        clearInput();
+        inputSkipped = false;
+    }
 }
 
 #pragma GCC push_options
@@ -425,6 +542,7 @@ void Dattorro::freeze(bool freezeFlag) {
 
 void Dattorro::setInputFilterLowCutoffPitch(float pitch) {
     inputLowCut = 440.0 * std::pow(2.0, pitch - 5.0);
+    inputLowCutRamp.set(inputLowCut);
 }
 
 #pragma GCC pop_options
@@ -439,6 +557,7 @@ void Dattorro::setInputFilterLowCutoffPitch(float pitch) {
 
 void Dattorro::setInputFilterHighCutoffPitch(float pitch) {
     inputHighCut = 440.0 * std::pow(2.0, pitch - 5.0);
+    inputHighCutRamp.set(inputHighCut);
 }
 
 #pragma GCC pop_options
@@ -499,6 +618,13 @@ void Dattorro::setTankModShape(const float modShape) {
     tank.setModShape(modShape);
 }
 
+void Dattorro::setParameterRampLength(int samples) {
+    preDelayRamp.setLength(samples);
+    inputHighCutRamp.setLength(samples);
+    inputLowCutRamp.setLength(samples);
+    tank.setParameterRampLength(samples);
+}
+
 float Dattorro::getLeftOutput() const {
     return leftOut;
 }
@@ -8,6 +8,56 @@
 #include "dsp/modulation/LFO.hpp"
 #include <array>
 
+// Linear ramp for parameters that are set at block rate. A setter calls
+// set() with the new value once per block; set() ignores an unchanged
+// value, so a static knob costs nothing, and process() steps towards a new
+// value over `length` samples. With the default length of 1 the new value
+// takes effect on the next sample, as if it had been set directly.
+class ParameterRamp {
+public:
+    explicit ParameterRamp(float initValue = 0.0) :
+        value(initValue), target(initValue) {}
+
+    void setLength(int samples) {
+        length = samples < 1 ? 1 : samples;
+    }
+
+    void set(float newTarget) {
+        if (newTarget == target) {
+            return;
+        }
+        target = newTarget;
+        step = (target - value) / length;
+        remaining = length;
+    }
+
+    // Goes straight to `newValue`, without ramping
+    void jump(float newValue) {
+        value = target = newValue;
+        remaining = 0;
+    }
+
+    bool moving() const {
+        return remaining > 0;
+    }
+
+    float next() {
+        value = (--remaining == 0) ? target : value + step;
+        return value;
+    }
+
+    float getValue() const {
+        return value;
+    }
+
+private:
+    float value;
+    float target;
+    float step = 0.0;
+    int length = 1;
+    int remaining = 0;
+};
+
 class Dattorro1997Tank {
 public:
     Dattorro1997Tank(const float initMaxSampleRate = 32000.0,
@@ -17,7 +67,14 @@ public:
     void process(const float leftInput, const float rightIn,
                  float* leftOut, float* rightOut);
 
+    // Cheaper process() for once isFrozen(): runs only the loop and the
+    // output taps
+    void processFrozen(float* leftOut, float* rightOut);
+
+    // freeze(true) fades the input and damping out over fadeTime; after
+    // that the tank is frozen and can run processFrozen()
     void freeze(const bool freezeFlag);
+    bool isFrozen() const;
 
     void setSampleRate(const float newSampleRate);
     void setTimeScale(const float newTimeScale);
@@ -33,6 +90,8 @@ public:
 
     void setDiffusion(const float diffusion);
 
+    void setParameterRampLength(int samples);
+
     void clear();
 
     int calcMaxTime(float delayTime);
@@ -114,17 +173,24 @@ public:
     float timeScale = 1.0;
 
     float modDepth = 0.0;
+    float modSpeed = 1.0;
     float decayParam = 0.0;
     float decay = 0.0;
 
     float lfoExcursion = 0.0;
 
+    // Decay and LFO excursion ramp to new values set at block rate
+    ParameterRamp decayRamp;
+    ParameterRamp lfoExcursionRamp;
+
     // Freeze Cross fade
     bool frozen = false;
     float fade = 1.0;
-    float fadeTime = 0.002;
+    float fadeTime = 0.05;
     float fadeStep = 1.0 / (fadeTime * sampleRate);
     float fadeDir = 1.0;
+    // Set while processFrozen() runs the loop at whole-sample delay times
+    bool loopRounded = false;
 
     TriSawLFO lfo1;
     TriSawLFO lfo2;
@@ -154,9 +220,11 @@ public:
     void initialiseDelaysAndApfs();
 
     void tickApfModulation();
+    void processOutputTaps(float* leftOut, float* rightOut);
 
     void rescaleApfAndDelayTimes();
     void rescaleTapTimes();
+    void roundLoopDelayTimes();
 };
 
 class Dattorro {
@@ -186,6 +254,11 @@ public:
     void setTankModDepth(const float modDepth);
     void setTankModShape(const float modShape);
 
+    // Spreads changes to the pre-delay, input filter cutoffs, decay and
+    // modulation depth over this many samples; set it to the audio block size when the setters
+    // are called once per block
+    void setParameterRampLength(int samples);
+
     float getLeftOutput() const;
     float getRightOutput() const;
 
@@ -219,8 +292,11 @@ public:
     OnePoleHPFilter rightInputDCBlock;
     OnePoleLPFilter inputLpf;
     OnePoleHPFilter inputHpf;
+    ParameterRamp inputHighCutRamp;
+    ParameterRamp inputLowCutRamp;
 
     InterpDelay preDelay;
+    ParameterRamp preDelayRamp;
 
     AllpassFilter inApf1;
     AllpassFilter inApf2;
@@ -230,7 +306,11 @@ public:
     Dattorro1997Tank tank;
 
     float tankFeed = 0.0;
+    // Set while process() skips the input chain for a frozen tank; the
+    // chain is then stale and is cleared when the freeze is released
+    bool inputSkipped = false;
 
+    void clearInput();
     float dattorroScale(float delayTime);
 };
 
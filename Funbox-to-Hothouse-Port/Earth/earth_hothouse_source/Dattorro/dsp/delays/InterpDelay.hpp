@@ -105,6 +105,16 @@ public:
 
     #pragma GCC pop_options
 
+    // Rounds the delay time to a whole number of samples, so that process()
+    // reads without interpolating. Each interpolated read loses a little of
+    // the high end, which adds up in a loop that never decays.
+    inline void roundDelayTime() {
+        if (f >= 0.5) {
+            ++t;
+        }
+        f = 0.;
+    }
+
     void clear() {
         // uint32_t **tempPtr = (uint32_t**)sdramData;
         for(int i = 0; i < l; ++i) {
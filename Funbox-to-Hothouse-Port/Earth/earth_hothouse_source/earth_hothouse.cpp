@@ -10,6 +10,7 @@
 #include "daisysp.h"
 #include "hothouse.h"
 #include "expressionHandler.h"
+#include "memory_placement.h"
 
 #include "Dattorro/Dattorro.hpp"
 
@@ -17,6 +18,7 @@
 #include <q/fx/biquad.hpp>
 #include "Util/Multirate.h"
 #include "Util/OctaveGenerator.h"
+#include "Util/Version.h"
 namespace q = cycfi::q;
 using namespace q::literals;
 
@@ -24,6 +26,8 @@ using namespace daisy;
 using namespace daisysp;
 using namespace clevelandmusicco;
 
+static_assert(OCTAVE_DSP_VERSION_MAJOR == 1, "written against OctaveDSP 1.x");
+
 // Declare hardware
 Hothouse hw;
 float pdamp, pmix, pdecay, pmoddepth, pmodspeed, ppredelay;
@@ -55,15 +59,68 @@ bool fw2_held = false;
 bool effect_on_momentary = false;
 bool freeze = false;
 
-static Decimator2 decimate;
-static Interpolator interpolate;
 static const auto sample_rate_temp = 48000;
-static OctaveGenerator octave(sample_rate_temp / resample_factor);
+// Octave band layout (override from the Makefile, see OctaveGenerator.h)
+#ifndef OCTAVE_BANDS
+#define OCTAVE_BANDS 80
+#endif
+#ifndef OCTAVE_LOW_HZ
+#define OCTAVE_LOW_HZ OctaveGenerator<>::default_low_hz
+#endif
+#ifndef OCTAVE_HIGH_HZ
+#define OCTAVE_HIGH_HZ OctaveGenerator<>::default_high_hz
+#endif
+#ifndef OCTAVE_SLEEP_LEVEL
+#define OCTAVE_SLEEP_LEVEL 0.0001f  // -80 dB; 0 processes every band every sample
+#endif
+#ifndef OCTAVE_QUALITY
+#define OCTAVE_QUALITY fast  // phase scaling kernel: reference, fast or high
+#endif
+// Memory region for the octave engine (see memory_placement.h)
+#ifndef EARTH_OCTAVE_MEM
+#define EARTH_OCTAVE_MEM DTCM
+#endif
+// The octave engine is built by its constructor, before hw.Init()
+static_assert(MEM_CONSTRUCTIBLE(EARTH_OCTAVE_MEM), "EARTH_OCTAVE_MEM: the octave engine can't go in SDRAM");
 static q::highshelf eq1(-11, 140_Hz, sample_rate_temp);
 static q::lowshelf eq2(5, 160_Hz, sample_rate_temp);
-float buff[6];
-float buff_out[6];
-int bin_counter = 0;
+
+// Octave generation at the decimated rate. The octave input is the raw
+// guitar input, so the whole callback block goes through MultirateScheduler
+// in one pass before the per-sample reverb loop. The stage owns the
+// generator, so the whole octave engine is the one `multirate` object.
+struct OctaveStage
+{
+    OctaveGenerator<OCTAVE_BANDS> octave{sample_rate_temp / resample_factor,
+                                         OCTAVE_BANDS, OCTAVE_LOW_HZ, OCTAVE_HIGH_HZ};
+
+    void process(const float* in, float* out, std::size_t count)
+    {
+        octave.process(in, count, up1, down1, down2);
+
+        for (size_t j = 0; j < count; ++j) {
+            float octave_mix = 0.0;
+            if (effect_mode == 1 || effect_mode == 2) {
+                octave_mix += up1[j] * 2.0;
+            }
+            if (effect_mode == 2) {
+                octave_mix += down1[j] * 2.0;
+                octave_mix += down2[j] * 2.0;
+            }
+            out[j] = octave_mix;
+        }
+    }
+
+    float up1[max_low_rate_block];
+    float down1[max_low_rate_block];
+    float down2[max_low_rate_block];
+};
+// Its constructor sets every piece of state at startup, so unlike the plain
+// buffers in other projects it needs no clearing in main() in a NOLOAD
+// region (but can't go in SDRAM, see above)
+static MultirateScheduler<OctaveStage> MEM_PLACE(EARTH_OCTAVE_MEM) multirate;
+static const size_t audio_block_size = 48;
+float octave_block[audio_block_size];
 
 float current_predelay, current_moddepth, current_modspeed, current_ODswell, current_freezeDecay;
 float setTimeScale, current_timeScale, setOD;
@@ -132,6 +189,7 @@ void UpdateButtons()
         fw2_held = true;
         if (footswitch_mode == 0) {
             freeze = true;
+            reverb.freeze(true);
         } else if (footswitch_mode == 1) {
             setOD = 0.6f;
             odOn = true;
@@ -142,6 +200,7 @@ void UpdateButtons()
     else if (!fs2_pressed && fw2_held) {
         fw2_held = false;
         freeze = false;
+        reverb.freeze(false);
         setOD = 0.4f;
         odOn = false;
         effect_on_momentary = false;
@@ -174,19 +233,25 @@ void UpdateSwitches()
     first_start = false;
 }
 
+// processSmoothedParameters() runs once per audio block, so the smoothing
+// coefficients are the per-sample ones compounded over a block. The reverb
+// ramps each change linearly over the following block (see ParameterRamp).
+static const float smooth_coeff = 1.0f - powf(1.0f - .0002f, audio_block_size);
+static const float od_smooth_coeff = 1.0f - powf(1.0f - .000015f, audio_block_size);
+
 void processSmoothedParameters()
 {
-    fonepole(current_predelay, ppredelay, .0002f);
+    fonepole(current_predelay, ppredelay, smooth_coeff);
     reverb.setPreDelay(current_predelay);
 
-    fonepole(current_moddepth, pmoddepth, .0002f);
+    fonepole(current_moddepth, pmoddepth, smooth_coeff);
     reverb.setTankModDepth(current_moddepth * 8);
 
-    fonepole(current_modspeed, pmodspeed, .0002f);
+    fonepole(current_modspeed, pmodspeed, smooth_coeff);
     reverb.setTankModSpeed(0.3 + current_modspeed * 15);
 
     if (odOn) {
-        fonepole(current_ODswell, setOD, .000015f);
+        fonepole(current_ODswell, setOD, od_smooth_coeff);
         overdrive.SetDrive(current_ODswell);
         overdrive2.SetDrive(current_ODswell);
         if (current_ODswell < 0.41 && !fw2_held) {
@@ -195,9 +260,9 @@ void processSmoothedParameters()
     }
 
     if (freeze) {
-        fonepole(current_freezeDecay, 1.0, .0002f); 
+        fonepole(current_freezeDecay, 1.0, smooth_coeff); 
     } else {
-        fonepole(current_freezeDecay, pdecay, .0002f); 
+        fonepole(current_freezeDecay, pdecay, smooth_coeff); 
     }
     reverb.setDecay(current_freezeDecay);
 }
@@ -275,51 +340,22 @@ static void AudioCallback(AudioHandle::InputBuffer in,
     float inputR;
 
     if(!bypass) {
+        // Octave path for the whole block
+        if (effect_mode != 0) {
+            multirate.process(in[0], octave_block, size);
+        }
+
+        processSmoothedParameters();
+
         for (size_t i = 0; i < size; i++)
         {
-            processSmoothedParameters();
             inputL = inputR = in[0][i];
             
-            // Buffer input for octave processing
-            buff[bin_counter] = inputL;
-            
-            // Process octave every 6 samples
-            if (bin_counter == 5) {
-                if (effect_mode != 0) {
-                    std::span<const float, resample_factor> in_chunk(&(buff[0]), resample_factor);
-                    const auto sample = decimate(in_chunk); 
-                    
-                    float octave_mix = 0.0;
-                    octave.update(sample);
-                    
-                    if (effect_mode == 1 || effect_mode == 2) {
-                        octave_mix += octave.up1() * 2.0;
-                    }
-                    if (effect_mode == 2) {
-                        octave_mix += octave.down1() * 2.0;
-                        octave_mix += octave.down2() * 2.0;
-                    }
-                    
-                    auto out_chunk = interpolate(octave_mix);
-                    for (size_t j = 0; j < out_chunk.size(); ++j) {
-                        float mix = eq2(eq1(out_chunk[j]));
-                        float dryLevel = 0.5;
-                        mix += dryLevel * buff[j];
-                        buff_out[j] = mix;
-                    }
-                } else {
-                    for (size_t j = 0; j < 6; ++j) {
-                        buff_out[j] = buff[j];
-                    }
-                }
-            }
-            
-            // Select input for reverb
-            float reverb_in;
-            if (effect_mode != 0 && bin_counter < 6) {
-                reverb_in = buff_out[bin_counter];
-            } else {
-                reverb_in = inputL;
+            // Select input for reverb, with the octaves mixed in
+            float reverb_in = inputL;
+            if (effect_mode != 0) {
+                float dryLevel = 0.5;
+                reverb_in = eq2(eq1(octave_block[i])) + dryLevel * inputL;
             }
             
             // Process reverb
@@ -343,12 +379,6 @@ static void AudioCallback(AudioHandle::InputBuffer in,
             
             out[0][i] = leftOutput;
             out[1][i] = rightOutput;
-            
-            // Update bin counter
-            bin_counter++;
-            if (bin_counter >= 6) {
-                bin_counter = 0;
-            }
         }
     } else {
         for (size_t i = 0; i < size; i++)
@@ -414,7 +444,7 @@ int main(void)
     float samplerate;
 
     hw.Init();
-    hw.SetAudioBlockSize(48);
+    hw.SetAudioBlockSize(audio_block_size);
     samplerate = hw.AudioSampleRate();
 
     reverb.setSampleRate(samplerate);
@@ -430,12 +460,12 @@ int main(void)
     reverb.setTankModSpeed(1.0);
     reverb.setTankModDepth(0.0);
     reverb.setTankModShape(0.5);
+    // After the initial settings, so that they apply without a ramp
+    reverb.setParameterRampLength(audio_block_size);
     reverb.clear();
 
-    for (int j = 0; j < 6; ++j) {
-        buff[j] = 0.0;
-        buff_out[j] = 0.0;
-    }
+    multirate.stage().octave.setSleepThreshold(OCTAVE_SLEEP_LEVEL);
+    multirate.stage().octave.setQuality(ShifterQuality::OCTAVE_QUALITY);
 
     overdrive.Init();
     overdrive.SetDrive(0.4);
@@ -1,30 +1,34 @@
 // Expression Handler for Earth Hothouse
 // Manages expression pedal mapping to knob parameters
+// Storage is fixed at compile time (max_params), so there is no heap use
 
 #ifndef EXPRESSION_HANDLER_H
 #define EXPRESSION_HANDLER_H
 
+#include <array>
+
 class ExpressionHandler {
+public:
+    static constexpr int max_params = 6;
+
 private:
     bool expression_set_mode;
     int num_params;
-    float* heel_values;
-    float* toe_values;
-    bool* param_active;
+    std::array<float, max_params> heel_values;
+    std::array<float, max_params> toe_values;
+    std::array<bool, max_params> param_active;
     float led1_brightness;
     float led2_brightness;
     
 public:
     ExpressionHandler() : expression_set_mode(false), num_params(0), 
-                          heel_values(nullptr), toe_values(nullptr), 
-                          param_active(nullptr), led1_brightness(0.1f), 
+                          heel_values{}, toe_values{}, 
+                          param_active{}, led1_brightness(0.1f), 
                           led2_brightness(0.1f) {}
     
+    // params is clamped to max_params
     void Init(int params) {
-        num_params = params;
-        heel_values = new float[num_params];
-        toe_values = new float[num_params];
-        param_active = new bool[num_params];
+        num_params = params < max_params ? params : max_params;
         
         for(int i = 0; i < num_params; i++) {
             heel_values[i] = 0.0f;
@@ -33,12 +37,6 @@ public:
         }
     }
     
-    ~ExpressionHandler() {
-        if(heel_values) delete[] heel_values;
-        if(toe_values) delete[] toe_values;
-        if(param_active) delete[] param_active;
-    }
-    
     void Process(float expression_value, float* knob_values, float* output_values) {
         for(int i = 0; i < num_params; i++) {
             if(param_active[i]) {
@@ -0,0 +1,151 @@
+// Cost of Earth's reverb per sample: its parameter handling, once per
+// block as the firmware does it, with the knobs at rest and being swept;
+// and the frozen tank against the full network
+
+#include "Bench.h"
+
+#include "Reverb.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    using host::block;
+    using host::sample_rate;
+
+    constexpr int runs = 5;
+    constexpr std::size_t length = 4 * std::size_t(sample_rate);
+
+    std::vector<float> input()
+    {
+        std::vector<float> x(length);
+        std::uint32_t seed = 1;
+        for (auto& s : x)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            s = float(seed >> 9) * (1.0f / 8388608.0f) - 0.5f;
+        }
+        return x;
+    }
+
+    enum class Knobs
+    {
+        untouched,  // no setters called at all
+        rest,
+        swept
+    };
+
+    // Knob positions for block b: all of them swept back and forth every
+    // 2 s, smoothed as processSmoothedParameters() smooths them
+    host::Knobs knobs(Knobs mode, std::size_t b, host::Knobs smoothed)
+    {
+        host::Knobs target{0.2f, 0.7f, 0.5f, 0.3f, 0.4f};
+        if (mode == Knobs::swept)
+        {
+            const float t = float(b * block) / sample_rate;
+            const float sweep = std::fabs(std::fmod(t, 2.0f) - 1.0f);
+            target = {sweep, 0.4f + 0.5f * sweep, sweep, 1 - sweep, sweep};
+        }
+        const float coeff = 1.0f - std::pow(1.0f - .0002f, float(block));
+        smoothed.predelay += coeff * (target.predelay - smoothed.predelay);
+        smoothed.decay += coeff * (target.decay - smoothed.decay);
+        smoothed.moddepth += coeff * (target.moddepth - smoothed.moddepth);
+        smoothed.modspeed += coeff * (target.modspeed - smoothed.modspeed);
+        smoothed.damp = target.damp;  // the firmware sets the damping unsmoothed
+        return smoothed;
+    }
+
+    // One reverb per case, run block by block in turn so that the host's
+    // speed changes hit every case alike. Each block's cost is the fastest
+    // of several runs; the total is per sample.
+    struct Case
+    {
+        Knobs mode;
+        bool frozen = false;
+        std::unique_ptr<Dattorro> reverb = host::reverb();
+        host::Knobs previous{}, current{};
+        std::vector<std::uint64_t> ticks;
+        double cost = 0;
+    };
+
+    void time(std::vector<Case>& cases, const std::vector<float>& x)
+    {
+        const std::size_t blocks = x.size() / block;
+        const host::Knobs start{0.2f, 0.7f, 0.5f, 0.3f, 0.4f};
+        for (auto& c : cases)
+        {
+            c.ticks.assign(blocks, ~std::uint64_t(0));
+            c.reverb->freeze(c.frozen);
+        }
+
+        for (int run = 0; run < runs; ++run)
+        {
+            for (auto& c : cases)
+            {
+                c.reverb->clear();
+                c.previous = {};
+                c.current = start;
+                host::update(*c.reverb, c.current, c.previous);
+            }
+
+            for (std::size_t b = 0; b < blocks; ++b)
+            {
+                const float* in = &x[b * block];
+                for (auto& c : cases)
+                {
+                    const std::uint64_t begin = bench::ticks();
+                    if (c.mode != Knobs::untouched)
+                    {
+                        c.previous = c.current;
+                        c.current = knobs(c.mode, b, c.current);
+                        host::update(*c.reverb, c.current, c.previous);
+                    }
+                    for (std::size_t i = 0; i < block; ++i)
+                    {
+                        c.reverb->process(in[i], in[i]);
+                    }
+                    c.ticks[b] = std::min(c.ticks[b], bench::ticks() - begin);
+                    bench::sink = c.reverb->getLeftOutput();
+                }
+            }
+        }
+
+        for (auto& c : cases)
+        {
+            c.cost = 0;
+            for (const std::uint64_t t : c.ticks)
+            {
+                c.cost += double(t);
+            }
+            c.cost /= double(blocks * block);
+        }
+    }
+}
+
+int main()
+{
+    const auto x = input();
+
+    // Frozen from the start; the 50 ms fade is over by the second run,
+    // which the fastest-of timing then picks
+    std::vector<Case> cases(4);
+    cases[0].mode = Knobs::untouched;
+    cases[1].mode = Knobs::rest;
+    cases[2].mode = Knobs::swept;
+    cases[3].mode = Knobs::rest;
+    cases[3].frozen = true;
+    time(cases, x);
+
+    const double alone = cases[0].cost;
+    std::printf("reverb, per sample\n");
+    std::printf("  process() alone         %6.1f %s\n", alone, bench::unit());
+    std::printf("  knobs at rest           %6.1f %s (%+.1f for the parameters)\n", cases[1].cost, bench::unit(),
+                cases[1].cost - alone);
+    std::printf("  knobs swept             %6.1f %s (%+.1f for the parameters)\n", cases[2].cost, bench::unit(),
+                cases[2].cost - alone);
+    std::printf("  frozen, knobs at rest   %6.1f %s (%.2fx running)\n", cases[3].cost, bench::unit(),
+                cases[3].cost / cases[1].cost);
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Earth's reverb with its parameters set once per block: unchanged values
+// leave the output alone, and a damping sweep follows one set every sample.
+// Its freeze: a frozen pad holds its level while the input keeps playing,
+// and releasing it doesn't replay what the input chain held from before.
+
+#include "Test.h"
+
+#include "Reverb.h"
+
+#include <vector>
+
+namespace
+{
+    using host::block;
+    using host::sample_rate;
+
+    constexpr float pi = std::numbers::pi_v<float>;
+
+    struct Noise
+    {
+        std::uint32_t seed = 1;
+
+        float operator()()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return float(seed >> 9) * (1.0f / 8388608.0f) - 0.5f;
+        }
+    };
+
+    double energy(const std::vector<float>& x, std::size_t from, std::size_t to)
+    {
+        double sum = 0;
+        for (std::size_t n = from; n < to; ++n)
+        {
+            sum += double(x[n]) * x[n];
+        }
+        return sum;
+    }
+
+    // Setting the same values every block, as the firmware does with the
+    // knobs at rest, gives the output of setting them once
+    void unchanged()
+    {
+        const host::Knobs knobs{0.2f, 0.7f, 0.5f, 0.3f, 0.4f};
+        auto every = host::reverb();
+        auto once = host::reverb();
+        host::update(*once, knobs, host::Knobs{});
+
+        Noise noise;
+        std::size_t differ = 0;
+        const std::size_t length = 2 * std::size_t(sample_rate);
+        for (std::size_t n = 0; n < length; ++n)
+        {
+            if (n % block == 0)
+            {
+                host::update(*every, knobs, n ? knobs : host::Knobs{});
+            }
+            const float x = n < length / 4 ? noise() : 0;
+            every->process(x, x);
+            once->process(x, x);
+            differ += (every->getLeftOutput() != once->getLeftOutput() ||
+                       every->getRightOutput() != once->getRightOutput()) ? 1 : 0;
+        }
+        test::check(differ == 0, "knobs at rest: setting them every block == setting them once, %zu of %zu samples differ",
+                    differ, length);
+    }
+
+    // Input damping swept 10 -> 3 -> 10 over 1 s, on what the input chain
+    // feeds the tank
+    std::vector<float> sweep(bool per_sample, std::size_t lag)
+    {
+        auto reverb = host::reverb();
+        reverb->enableInputDiffusion(false);
+        reverb->setDecay(0.0f);
+        reverb->setParameterRampLength(per_sample ? 1 : block);
+
+        std::vector<float> y(static_cast<std::size_t>(sample_rate));
+        for (std::size_t n = 0; n < y.size(); ++n)
+        {
+            if (per_sample || n % block == 0)
+            {
+                const float t = (float(n) - float(lag)) / sample_rate;
+                const float amount = t < 0 ? 0 : t < 0.5f ? 2 * t : std::max(0.0f, 2 - 2 * t);
+                reverb->setInputFilterHighCutoffPitch(10. - 7. * amount);
+            }
+            const float x = 0.5f * std::sin(2 * pi * 2000 * float(n) / sample_rate);
+            reverb->process(x, x);
+            y[n] = reverb->tankFeed;
+        }
+        return y;
+    }
+
+    // The block-rate setter ramps to each value over the following block,
+    // so it trails the per-sample reference by one block
+    void damping()
+    {
+        const auto ramped = sweep(false, 0);
+        const auto reference = sweep(true, block);
+        const double residual = -test::snrDb(reference, ramped);
+        test::check(residual < -70, "damping swept at block rate against every sample: residual %.1f dB", residual);
+    }
+
+    // 1 s of noise through a 0.5 s pre-delay, frozen for 2 s with silent
+    // input, then released: the tank gets nothing in the following second
+    void release()
+    {
+        auto reverb = host::reverb();
+        reverb->setPreDelay(0.5f);
+        reverb->setDecay(0.8f);
+
+        Noise noise;
+        const std::size_t second = std::size_t(sample_rate);
+        for (std::size_t n = 0; n < second; ++n)
+        {
+            const float x = noise();
+            reverb->process(x, x);
+        }
+        reverb->freeze(true);
+        for (std::size_t n = 0; n < 2 * second; ++n)
+        {
+            reverb->process(0, 0);
+        }
+        reverb->freeze(false);
+        double feed = 0;
+        for (std::size_t n = 0; n < second; ++n)
+        {
+            reverb->process(0, 0);
+            feed += double(reverb->tankFeed) * reverb->tankFeed;
+        }
+        test::check(feed == 0, "released freeze: tank feed energy %g in the following second", feed);
+    }
+
+    // A pad of noise frozen for 8 s while the noise keeps playing: each
+    // second's level within 0.5 dB of the first frozen second's
+    void frozen()
+    {
+        auto reverb = host::reverb();
+        reverb->setDecay(0.8f);
+
+        Noise noise;
+        const std::size_t second = std::size_t(sample_rate);
+        std::vector<float> y(10 * second);
+        for (std::size_t n = 0; n < y.size(); ++n)
+        {
+            if (n == second)
+            {
+                reverb->freeze(true);
+            }
+            const float x = noise();
+            reverb->process(x, x);
+            y[n] = reverb->getLeftOutput();
+        }
+
+        // From 1 s after the freeze, past its 50 ms fade
+        const double first = energy(y, 2 * second, 3 * second);
+        double worst = 0;
+        for (std::size_t s = 3; s < 10; ++s)
+        {
+            const double level = test::db(energy(y, s * second, (s + 1) * second) / first);
+            worst = std::fabs(level) > std::fabs(worst) ? level : worst;
+        }
+        test::check(std::fabs(worst) < 0.5, "frozen for 8 s with the input playing: level within %+.2f dB", worst);
+    }
+}
+
+int main()
+{
+    unchanged();
+    damping();
+    release();
+    frozen();
+
+    return test::result();
+}
@@ -0,0 +1,89 @@
+// Earth's Dattorro reverb as part of a host program, with the settings
+// earth_hothouse.cpp starts it with, and a stand-in for its once per block
+// parameter updates.
+#pragma once
+
+#include "Dattorro/Dattorro.cpp"
+#include "Dattorro/dsp/filters/OnePoleFilters.cpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+// As InterpDelay.cpp, but with more rows behind sdramData. Every InterpDelay
+// constructed takes the next row, temporaries included, so one Dattorro set
+// up as the firmware sets it up uses rows up to 46 of the 13 declared; on
+// the Seed those land in SDRAM nothing else uses. Here each reverb a program
+// creates gets its own rows.
+namespace host
+{
+    constexpr unsigned rows_per_reverb = 46;
+    constexpr unsigned max_reverbs = 8;
+}
+
+float host_sdram[1 + host::rows_per_reverb * host::max_reverbs][37000];
+extern float sdramData[13][37000] __attribute__((alias("host_sdram")));
+unsigned int count = 0;
+bool triggerClear;
+float clearPopCancelValue = 1.;
+float hold = 1.;
+
+namespace host
+{
+    constexpr float sample_rate = 48000;
+    constexpr std::size_t block = 48;  // audio_block_size
+
+    // A reverb set up as main() sets it up
+    inline std::unique_ptr<Dattorro> reverb()
+    {
+        if (count + rows_per_reverb >= sizeof(host_sdram) / sizeof(host_sdram[0]))
+        {
+            std::fprintf(stderr, "host::reverb(): out of delay rows, raise host::max_reverbs\n");
+            std::abort();
+        }
+
+        auto reverb = std::make_unique<Dattorro>(48000, 16, 4.0);
+        reverb->setSampleRate(sample_rate);
+        reverb->setTimeScale(2.0);
+        reverb->setPreDelay(0.0);
+        reverb->setInputFilterLowCutoffPitch(0.0);
+        reverb->setInputFilterHighCutoffPitch(10.0);
+        reverb->enableInputDiffusion(true);
+        reverb->setDecay(0.5);
+        reverb->setTankDiffusion(0.7);
+        reverb->setTankFilterLowCutFrequency(0.0);
+        reverb->setTankFilterHighCutFrequency(10.0);
+        reverb->setTankModSpeed(1.0);
+        reverb->setTankModDepth(0.0);
+        reverb->setTankModShape(0.5);
+        reverb->setParameterRampLength(block);
+        reverb->clear();
+        return reverb;
+    }
+
+    // The knobs processSmoothedParameters() and AudioCallback() hand to
+    // the reverb, as 0-1 knob positions
+    struct Knobs
+    {
+        float predelay = 0;
+        float decay = 0.5f;
+        float moddepth = 0;
+        float modspeed = 0;
+        float damp = 0;
+    };
+
+    // One block's parameter updates, as the firmware makes them: the
+    // smoothed parameters every block, and the damping when its knob moved
+    inline void update(Dattorro& reverb, const Knobs& knobs, const Knobs& previous)
+    {
+        reverb.setPreDelay(knobs.predelay);
+        reverb.setTankModDepth(knobs.moddepth * 8);
+        reverb.setTankModSpeed(0.3f + knobs.modspeed * 15);
+        reverb.setDecay(knobs.decay);
+        if (knobs.damp != previous.damp)
+        {
+            reverb.setInputFilterHighCutoffPitch(10. - (7. * knobs.damp));
+        }
+        reverb.enableInputDiffusion(true);
+    }
+}
@@ -0,0 +1,5 @@
+// Host stand-in for libDaisy: InterpDelay only needs the SDRAM section
+// attribute, which has no meaning on the host
+#pragma once
+
+#define DSY_SDRAM_BSS
@@ -1,27 +1,159 @@
 // fourier.h
 #ifndef FOURIER
 
+#include <math.h>
+#include <stdint.h>
+#include <array>
 #include "wave.h"
 
 namespace soundmath
 {
-	template <typename T, size_t N> class Fourier
+	// Storage policies for Fourier's overlap-add buffers. FloatStorage keeps
+	// them in T and runs the transforms in place. ScaledStorage stores them
+	// in a 16-bit codec: each slot is decoded into a float frame for the
+	// forward transform, and each resynthesized frame is stored with its own
+	// power-of-two scale (block floating point), so quiet tails keep their
+	// resolution. Windowed input is stored unscaled and has to stay within
+	// [-1, 1].
+	template <typename T> struct FloatStorage
+	{
+		typedef T sample;
+		static const bool scaled = false;
+
+		static sample encode(T x)
+		{
+			return x;
+		}
+
+		static T decode(sample x)
+		{
+			return x;
+		}
+
+		template <typename FFT> static void analyse(FFT* fft, sample* slot, T*, T* spectrum)
+		{
+			fft->Direct(slot, spectrum);
+		}
+
+		template <typename FFT> static void synthesise(FFT* fft, T* spectrum, sample* slot, T*, T&)
+		{
+			fft->Inverse(spectrum, slot);
+		}
+	};
+
+	// Q15: values handed to encode() are already normalized to [-1, 1]
+	struct Q15Codec
+	{
+		typedef int16_t sample;
+
+		static sample encode(float x)
+		{
+			x = x > 1.0f ? 1.0f : (x < -1.0f ? -1.0f : x);
+			return (int16_t)lrintf(x * 32767.0f);
+		}
+
+		static float decode(sample x)
+		{
+			return x * (1.0f / 32767.0f);
+		}
+	};
+
+#if defined(__ARM_FP16_FORMAT_IEEE)
+	typedef __fp16 half;
+#define FOURIER_HAS_HALF
+#elif defined(__FLT16_MAX__)
+	typedef _Float16 half;
+#define FOURIER_HAS_HALF
+#endif
+
+#ifdef FOURIER_HAS_HALF
+	struct HalfCodec
+	{
+		typedef half sample;
+
+		static sample encode(float x)
+		{
+			return (half)x;
+		}
+
+		static float decode(sample x)
+		{
+			return (float)x;
+		}
+	};
+#endif
+
+	template <typename Codec> struct ScaledStorage
+	{
+		typedef typename Codec::sample sample;
+		static const bool scaled = true;
+
+		static sample encode(float x)
+		{
+			return Codec::encode(x);
+		}
+
+		static float decode(sample x)
+		{
+			return Codec::decode(x);
+		}
+
+		template <typename FFT> static void analyse(FFT* fft, sample* slot, float* frame, float* spectrum)
+		{
+			for (size_t k = 0; k < FFT::max_size; k++)
+				frame[k] = decode(slot[k]);
+			fft->Direct(frame, spectrum);
+		}
+
+		template <typename FFT> static void synthesise(FFT* fft, float* spectrum, sample* slot, float* frame, float& scale)
+		{
+			fft->Inverse(spectrum, frame);
+
+			// pick the smallest power of two that covers the frame
+			float peak = 0;
+			for (size_t k = 0; k < FFT::max_size; k++)
+				peak = fmaxf(peak, fabsf(frame[k]));
+
+			int exponent = 0;
+			frexpf(peak, &exponent);
+			scale = ldexpf(1.0f, exponent);
+			float inverse_scale = 1 / scale;
+
+			for (size_t k = 0; k < FFT::max_size; k++)
+				slot[k] = encode(frame[k] * inverse_scale);
+		}
+	};
+
+
+	// Overlap-add STFT with a mono input and Channels outputs. Each hop does
+	// one forward transform and hands the spectrum to a processor that writes
+	// one spectrum per channel, each with its own inverse transform (for
+	// stereo, one FFT and two IFFTs per hop instead of two of each for a pair
+	// of mono STFTs). The spectra only live for the duration of a hop.
+	template <typename T, size_t N, size_t Channels = 1, typename Storage = FloatStorage<T> > class Fourier
 	{
 	public:
-		void (*processor)(const T* in, T* out);
+		typedef typename Storage::sample sample;
 
-		// in, middle, out need to be arrays of size (N * laps * 2)
-		Fourier(void (*processor)(const T*, T*), ShyFFT<T, N, RotationPhasor>* fft, Wave<T>* window, size_t laps, T* in, T* middle, T* out) 
-			: processor(processor), in(in), middle(middle), out(out), fft(fft), window(window), laps(laps), stride(N / laps)
+		void (*processor)(const T* in, T* const* out);
+
+		// in[c] are the overlap-add buffers and need to be arrays of size
+		// (N * laps * 2); middle and out[c] are scratch of size N, and so is
+		// frame, which only ScaledStorage uses
+		Fourier(void (*processor)(const T*, T* const*), ShyFFT<T, N, RotationPhasor>* fft, Wave<T>* window, size_t laps, const std::array<sample*, Channels>& in, T* middle, const std::array<T*, Channels>& out, T* frame = nullptr) 
+			: processor(processor), in(in), middle(middle), out(out), frame(frame), fft(fft), window(window), laps(laps), stride(N / laps)
 		{
 			writepoints = new int[laps * 2];
 			readpoints = new int[laps * 2];
+			scales = new T[laps * 2 * Channels];
 
 			memset(writepoints, 0, sizeof(int) * laps * 2);
 			memset(readpoints, 0, sizeof(int) * laps * 2);
 
 			for (int i = 0; i < 2 * (int)laps; i++) // initialize half of writepoints
 				writepoints[i] = -i * (int)stride;
+			for (size_t i = 0; i < laps * 2 * Channels; i++)
+				scales[i] = 1;
 
 			reading = new bool[laps * 2];
 			writing = new bool[laps * 2];
@@ -34,6 +166,7 @@ namespace soundmath
 		{
 			delete [] writepoints;
 			delete [] readpoints;
+			delete [] scales;
 			delete [] reading;
 			delete [] writing;
 		}
@@ -48,7 +181,7 @@ namespace soundmath
 					if (writepoints[i] >= 0)
 					{
 						T amp = (*window)((T)writepoints[i] / N);
-						in[writepoints[i] + N * i] = amp * x;
+						in[0][writepoints[i] + N * i] = Storage::encode(amp * x);
 					}
 					writepoints[i]++;
 
@@ -58,9 +191,7 @@ namespace soundmath
 						reading[i] = true;
 						readpoints[i] = 0;
 
-						forward(i); // FTs ith in to ith middle buffer
-						process(i); // user-defined; ought to move info from ith middle to out buffer
-						backward(i); // IFTs ith out to ith in buffer
+						hop(i);
 
 						current = i;
 					}
@@ -68,35 +199,31 @@ namespace soundmath
 			}
 		}
 
-		inline void forward(const size_t i)
-		{
-			fft->Direct((in + i * N), (middle + i * N)); // analysis
-			// arm_rfft_fast_f32(fft, in + i * N, middle + i * N, 0);
-		}
-
-		inline void backward(const size_t i)
+		// transforms the ith frame, runs the user-defined callback on it
+		// and resynthesizes each channel into its ith slot
+		void hop(const size_t i)
 		{
-			fft->Inverse((out + i * N), (in + i * N)); // synthesis
-			// arm_rfft_fast_f32(fft, out + i * N, in + i * N, 1);
+			Storage::analyse(fft, in[0] + i * N, frame, middle);
+			processor(middle, out.data());
+			for (size_t c = 0; c < Channels; c++)
+				Storage::synthesise(fft, out[c], in[c] + i * N, frame, scales[c * laps * 2 + i]);
 		}
 
-		// executes user-defined callback
-		inline void process(const size_t i)
+		// read a single reconstructed sample for each channel
+		void read(T* samples)
 		{
-			processor((middle + i * N), (out + i * N));
-		}
-
-		// read a single reconstructed sample
-		T read()
-		{
-			T accum = 0;
+			T accum[Channels] = {};
 
 			for (size_t i = 0; i < laps * 2; i++)
 			{
 				if (reading[i])
 				{
 					T amp = (*window)((T)readpoints[i] / N);
-					accum += amp * in[readpoints[i] + N * i];
+					for (size_t c = 0; c < Channels; c++)
+					{
+						T gain = Storage::scaled ? amp * scales[c * laps * 2 + i] : amp;
+						accum[c] += gain * Storage::decode(in[c][readpoints[i] + N * i]);
+					}
 
 					readpoints[i]++;
 
@@ -109,14 +236,32 @@ namespace soundmath
 				}
 			}
 
-			accum /= N * laps / 2.0;
-			return accum;
+			for (size_t c = 0; c < Channels; c++)
+				samples[c] = accum[c] / (N * laps / 2.0);
 		}
 
+		T read()
+		{
+			static_assert(Channels == 1, "read() is for mono output");
+			T value;
+			read(&value);
+			return value;
+		}
 
+		void read(T& left, T& right)
+		{
+			static_assert(Channels == 2, "read(left, right) is for stereo output");
+			T samples[2];
+			read(samples);
+			left = samples[0];
+			right = samples[1];
+		}
 
 	private:
-		T *in, *middle, *out;
+		std::array<sample*, Channels> in;
+		T* middle;
+		std::array<T*, Channels> out;
+		T* frame;
 
 	public:
 		ShyFFT<T, N, RotationPhasor>* fft;
@@ -127,6 +272,7 @@ namespace soundmath
 
 		int* writepoints;
 		int* readpoints;
+		T* scales; // per-frame scale of each channel's slots
 		bool* reading;
 		bool* writing;
 
@@ -0,0 +1,207 @@
+// Fourier's compact overlap-add buffers against float ones, with a stand-in
+// for Venus's fast reverb tier as the processor: the output's SNR for Q15
+// and half floats, and a stereo Fourier that matches two mono ones
+//
+// The input is a decaying chord for 2 s, then 3 s of silence for the tail,
+// at 32 kHz with the decay and damping Venus ships with.
+
+#include "Test.h"
+
+#include <cstdint>
+#include <cstring>  // fourier.h uses memset, and relies on its includer for it
+
+#include "shy_fft.h"
+#include "fourier.h"
+#include "wave.h"
+
+using namespace soundmath;
+
+namespace
+{
+    constexpr std::size_t N = 4096;
+    constexpr std::size_t laps = 4;
+    constexpr float sample_rate = 32000;
+    constexpr float decay = 30;
+    constexpr float damp = 0.3f;
+    constexpr float pi = std::numbers::pi_v<float>;
+
+    typedef ShyFFT<float, N, RotationPhasor> FFT;
+
+    FFT fft;
+    Wave<float> hann([](float phase) -> float { return 0.5f * (1 - std::cos(2 * pi * phase)); });
+
+    // reverbFast() from venus_hothouse.cpp over every bin, with its own
+    // phase generator so each channel's output is reproducible
+    struct Reverb
+    {
+        float energy[N / 2] = {};
+        std::uint32_t seed = 1;
+
+        float phase()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return float(seed >> 8) * (2 * pi / 16777216.0f);
+        }
+
+        void process(const float* in, float* out)
+        {
+            const float fft_size = N / 2;
+            const float decay_gain = 1.0f - 1.0f / decay;
+            for (std::size_t i = 0; i < N / 2; ++i)
+            {
+                const float real = in[i];
+                const float imag = in[i + N / 2];
+
+                const float bin = float(i + 1);
+                float amp = std::sqrt(energy[i]);
+                if (bin / fft_size > damp)
+                {
+                    amp *= damp * fft_size / bin;
+                }
+                const float p = phase();
+                out[i] = amp * std::cos(p);
+                out[i + N / 2] = amp * std::sin(p);
+
+                energy[i] += (real * real + imag * imag) / laps;
+                energy[i] *= decay_gain;
+            }
+        }
+    };
+
+    Reverb left, right;
+
+    void reset()
+    {
+        left = Reverb{};
+        right = Reverb{};
+        right.seed = 2;
+    }
+
+    void monoLeft(const float* in, float* const* out)
+    {
+        left.process(in, out[0]);
+    }
+
+    void monoRight(const float* in, float* const* out)
+    {
+        right.process(in, out[0]);
+    }
+
+    void stereo(const float* in, float* const* out)
+    {
+        left.process(in, out[0]);
+        right.process(in, out[1]);
+    }
+
+    std::vector<float> input()
+    {
+        std::vector<float> x(5 * std::size_t(sample_rate));
+        for (std::size_t k = 0; k < x.size(); ++k)
+        {
+            const float t = float(k) / sample_rate;
+            const float env = k < 2 * std::size_t(sample_rate) ? std::exp(-3 * std::fmod(t, 0.5f)) : 0;
+            x[k] = 0.5f * env *
+                   (std::sin(2 * pi * 196 * t) + 0.5f * std::sin(2 * pi * 392 * t) + 0.25f * std::sin(2 * pi * 1175 * t)) /
+                   1.75f;
+        }
+        return x;
+    }
+
+    // One Fourier with the firmware's buffer sizes; y[c] gets channel c
+    template <typename Storage, std::size_t Channels>
+    void render(void (*processor)(const float*, float* const*), const std::vector<float>& x,
+                std::array<std::vector<float>, Channels>& y)
+    {
+        typedef typename Storage::sample sample;
+        std::vector<sample> in(Channels * 2 * laps * N);
+        std::vector<float> middle(N), out(Channels * N), frame(N);
+        std::array<sample*, Channels> ins;
+        std::array<float*, Channels> outs;
+        for (std::size_t c = 0; c < Channels; ++c)
+        {
+            ins[c] = &in[c * 2 * laps * N];
+            outs[c] = &out[c * N];
+        }
+
+        Fourier<float, N, Channels, Storage> stft(processor, &fft, &hann, laps, ins, middle.data(), outs, frame.data());
+        float samples[Channels];
+        for (std::size_t c = 0; c < Channels; ++c)
+        {
+            y[c].resize(x.size());
+        }
+        for (std::size_t k = 0; k < x.size(); ++k)
+        {
+            stft.write(x[k]);
+            stft.read(samples);
+            for (std::size_t c = 0; c < Channels; ++c)
+            {
+                y[c][k] = samples[c];
+            }
+        }
+    }
+
+    template <typename Storage>
+    std::vector<float> mono(const std::vector<float>& x)
+    {
+        reset();
+        std::array<std::vector<float>, 1> y;
+        render<Storage>(monoLeft, x, y);
+        return y[0];
+    }
+
+    template <typename Storage>
+    std::array<std::vector<float>, 2> pair(const std::vector<float>& x)
+    {
+        reset();
+        std::array<std::vector<float>, 2> y;
+        render<Storage>(stereo, x, y);
+        return y;
+    }
+
+    template <typename Storage>
+    void compact(const char* name, const std::vector<float>& x, double min_db)
+    {
+        const auto want = mono<FloatStorage<float>>(x);
+        const auto got = mono<Storage>(x);
+        const double mono_db = test::snrDb(want, got);
+
+        const auto want_pair = pair<FloatStorage<float>>(x);
+        const auto got_pair = pair<Storage>(x);
+        const double left_db = test::snrDb(want_pair[0], got_pair[0]);
+        const double right_db = test::snrDb(want_pair[1], got_pair[1]);
+
+        test::check(mono_db > min_db && left_db > min_db && right_db > min_db,
+                    "%s against float: SNR %.1f dB mono, %.1f and %.1f dB stereo", name, mono_db, left_db, right_db);
+    }
+
+    // A stereo Fourier's two spectra each go through their own inverse
+    // transform and buffer, exactly as two mono Fouriers would
+    template <typename Storage>
+    void channels(const char* name, const std::vector<float>& x)
+    {
+        const auto both = pair<Storage>(x);
+
+        reset();
+        std::array<std::vector<float>, 1> l, r;
+        render<Storage>(monoLeft, x, l);
+        render<Storage>(monoRight, x, r);
+
+        test::check(both[0] == l[0] && both[1] == r[0], "%s: stereo == two mono Fouriers", name);
+    }
+}
+
+int main()
+{
+    fft.Init();
+    const auto x = input();
+
+    compact<ScaledStorage<Q15Codec>>("Q15", x, 85);
+#ifdef FOURIER_HAS_HALF
+    compact<ScaledStorage<HalfCodec>>("half", x, 70);
+#endif
+
+    channels<FloatStorage<float>>("float", x);
+    channels<ScaledStorage<Q15Codec>>("Q15", x);
+
+    return test::result();
+}
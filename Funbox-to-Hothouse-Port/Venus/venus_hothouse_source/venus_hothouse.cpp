@@ -7,6 +7,7 @@
 #include "shy_fft.h"
 #include "fourier.h"
 #include "wave.h"
+#include "memory_placement.h"
 
 #define PI 3.1415926535897932384626433832795
 
@@ -35,22 +36,88 @@ float vshimmer = 0.0, vshimmer_tone = 0.0, vdetune = 0.0;
 int shimmer_mode = 0, reverb_mode = 0, drift_mode = 1;  // Original defaults
 int detune_mode = 1, detune_multiplier = 1;
 
+// Memory regions for the STFT buffers (see memory_placement.h)
+// Override from the Makefile, e.g. make VENUS_IN_MEM=SDRAM
+#ifndef VENUS_IN_MEM
+#define VENUS_IN_MEM AXI
+#endif
+#ifndef VENUS_MIDDLE_MEM
+#define VENUS_MIDDLE_MEM AXI
+#endif
+#ifndef VENUS_OUT_MEM
+#define VENUS_OUT_MEM AXI
+#endif
+#ifndef VENUS_TABLE_MEM
+#define VENUS_TABLE_MEM DTCM
+#endif
+// The window table is filled by its constructor, before hw.Init()
+static_assert(MEM_CONSTRUCTIBLE(VENUS_TABLE_MEM), "VENUS_TABLE_MEM: the tables can't go in SDRAM");
+#ifndef VENUS_IN_R_MEM
+#define VENUS_IN_R_MEM D2
+#endif
+
+// Stereo mode: one forward FFT per hop, then left and right spectra with
+// independent random phases and an inverse FFT each. Build with
+// VENUS_STEREO=1 to enable it.
+#ifndef VENUS_STEREO
+#define VENUS_STEREO 0
+#endif
+
+// Reduced-precision STFT storage: 0 keeps every buffer in float, 1 stores
+// the overlap-add buffers as Q15 and 2 as half floats, each with a
+// power-of-two scale per frame. The FFT and reverb still run in float.
+#ifndef VENUS_COMPACT_BUFFERS
+#define VENUS_COMPACT_BUFFERS 0
+#endif
+
 // STFT components
 const size_t order = 12;
 const size_t N = (1 << order);
 const float sqrtN = sqrt(N);
 const size_t laps = 4;
 const size_t buffsize = 2 * laps * N;
-float in[buffsize], middle[buffsize], out[buffsize];
-float reverb_energy[N/2];
+const size_t channels = VENUS_STEREO ? 2 : 1;
+#if VENUS_COMPACT_BUFFERS == 2
+typedef ScaledStorage<HalfCodec> stft_storage;
+#elif VENUS_COMPACT_BUFFERS
+typedef ScaledStorage<Q15Codec> stft_storage;
+#else
+typedef FloatStorage<float> stft_storage;
+#endif
+typedef stft_storage::sample stft_sample;
+typedef Fourier<float, N, channels, stft_storage> Stft;
 
-ShyFFT<float, N, RotationPhasor>* fft;
-Fourier<float, N>* stft;
-Wave<float> hann([] (float phase) -> float { return 0.5 * (1 - cos(2 * PI * phase)); });
+// The overlap-add buffers hold 2 * laps frames; the spectra only live for
+// one hop
+stft_sample MEM_PLACE(VENUS_IN_MEM) in[buffsize];
+float MEM_PLACE(VENUS_MIDDLE_MEM) middle[N];
+float MEM_PLACE(VENUS_OUT_MEM) out[N];
+#if VENUS_COMPACT_BUFFERS
+float MEM_PLACE(VENUS_MIDDLE_MEM) frame[N];  // decoded frame for the transforms
+#endif
+float MEM_PLACE(VENUS_TABLE_MEM) reverb_energy[N/2];
+#if VENUS_STEREO
+stft_sample MEM_PLACE(VENUS_IN_R_MEM) in_r[buffsize];  // right channel resynthesis
+float MEM_PLACE(VENUS_OUT_MEM) out_r[N];  // right channel spectrum
+#endif
+
+// The FFT (twiddle and bit-reversal tables) and the window lookup table are
+// read on every hop, so they live with the other small hot tables
+ShyFFT<float, N, RotationPhasor> MEM_PLACE(VENUS_TABLE_MEM) fft;
+Stft* stft;
+Wave<float> MEM_PLACE(VENUS_TABLE_MEM) hann([] (float phase) -> float { return 0.5 * (1 - cos(2 * PI * phase)); });
+
+#ifdef VENUS_BENCHMARK
+// Benchmark mode: measures the audio callback load and prints it over USB
+// serial once per second (build with: make BENCHMARK=1)
+CpuLoadMeter cpu_meter;
+#endif
 
 // Audio processing objects
 SampleRateReducer samplerateReducer;
 Tone lowpass;  // Low Pass for lofi mode
+SampleRateReducer samplerateReducer_r;  // right channel, stereo mode only
+Tone lowpass_r;
 
 // Drift oscillators
 Oscillator drift_osc, drift_osc2, drift_osc3, drift_osc4;
@@ -86,11 +153,14 @@ void updateSwitch2()
         reverb_mode = 0;  // less lofi
         samplerateReducer.SetFreq(0.3);
         lowpass.SetFreq(8000.0);
+        samplerateReducer_r.SetFreq(0.3);
+        lowpass_r.SetFreq(8000.0);
     } else if (toggle2_pos == Hothouse::TOGGLESWITCH_MIDDLE) { // case 1 = physical MIDDLE
         reverb_mode = 1;  // normal
     } else if (toggle2_pos == Hothouse::TOGGLESWITCH_UP) {     // case 0 = physical UP
         reverb_mode = 2;  // more lofi
         samplerateReducer.SetFreq(0.2);
+        samplerateReducer_r.SetFreq(0.2);
     }
 }
 
@@ -226,8 +296,23 @@ void ProcessControls()
     detune_remainder = 1 - detune_double;
 }
 
+// Applies the lofi processing selected by switch 2 to one channel of wet signal
+inline float applyReverbMode(float wet, SampleRateReducer& reducer, Tone& filter)
+{
+    if (reverb_mode == 0) {  // less lofi
+        return filter.Process(reducer.Process(wet));
+    } else if (reverb_mode == 2) {  // more lofi
+        return reducer.Process(wet);
+    }
+    return wet;  // normal
+}
+
 void AudioCallback(AudioHandle::InputBuffer in_buf, AudioHandle::OutputBuffer out_buf, size_t size)
 {
+#ifdef VENUS_BENCHMARK
+    cpu_meter.OnBlockStart();
+#endif
+
     // Update LEDs at start of callback (matching original)
     led1.Update();
     led2.Update();
@@ -247,46 +332,198 @@ void AudioCallback(AudioHandle::InputBuffer in_buf, AudioHandle::OutputBuffer ou
         } else {
             stft->write(in_buf[0][i]);  // put a new sample in the STFT
             
-            float wet = 0.0;
-            if (reverb_mode == 0) {  // less lofi
-                wet = lowpass.Process(samplerateReducer.Process(stft->read()));
-            } else if (reverb_mode == 1) {  // normal
-                wet = stft->read();
-            } else if (reverb_mode == 2) {  // more lofi
-                wet = samplerateReducer.Process(stft->read());
-            }
+#if VENUS_STEREO
+            float wet_l, wet_r;
+            stft->read(wet_l, wet_r);
+            wet_l = applyReverbMode(wet_l, samplerateReducer, lowpass);
+            wet_r = applyReverbMode(wet_r, samplerateReducer_r, lowpass_r);
+            
+            // Mix wet and dry signals (mono in, stereo out)
+            out_buf[0][i] = wet_l * vmix + in_buf[0][i] * (1.0f - vmix);
+            out_buf[1][i] = wet_r * vmix + in_buf[0][i] * (1.0f - vmix);
+#else
+            float wet = applyReverbMode(stft->read(), samplerateReducer, lowpass);
             
             // Mix wet and dry signals
             out_buf[0][i] = wet * vmix + in_buf[0][i] * (1.0f - vmix);
             out_buf[1][i] = out_buf[0][i];  // Mono processing
+#endif
+        }
+    }
+
+#ifdef VENUS_BENCHMARK
+    cpu_meter.OnBlockEnd();
+#endif
+}
+
+// Bin processing tiers, selected once per hop from the control values.
+// The cheaper tiers produce the same output as the full path whenever they
+// are selected; they just skip work that would have no effect.
+enum ReverbTier {
+    TIER_FREEZE,  // frozen: resynthesize stored magnitudes, no energy update
+    TIER_FAST,    // shimmer and detune off: accumulate and decay energy only
+    TIER_FULL     // shimmer and/or detune on: also spread energy across bins
+};
+
+// Set VENUS_TIERED_BINS to 0 to always run the full path (for benchmarking)
+#ifndef VENUS_TIERED_BINS
+#define VENUS_TIERED_BINS 1
+#endif
+
+// Damped magnitudes held while frozen, rebuilt if the damping changes
+float MEM_PLACE(VENUS_TABLE_MEM) frozen_amp[N/2];
+bool frozen_amp_valid = false;
+float frozen_amp_damp = 0.0f;
+
+// Band-limited processing: only bins in [bin_lo, bin_hi) are processed, the
+// rest of the spectrum is left silent. "Guitar range" drops the top octave of
+// air (which the lofi modes filter out anyway) to roughly halve the per-bin
+// work. Build with VENUS_GUITAR_RANGE=1 to enable it.
+#ifndef VENUS_GUITAR_RANGE
+#define VENUS_GUITAR_RANGE 0
+#endif
+const float guitar_range_low_hz = 40.0f;
+const float guitar_range_high_hz = 8000.0f;
+
+// Bins at each edge of a limited band are faded in with a raised cosine so
+// the band edges don't ring in the resynthesized output
+const size_t band_edge_bins = 8;
+float band_edge_gain[band_edge_bins];
+
+size_t bin_lo = 0;
+size_t bin_hi = N / 2;
+
+// Sets the processed band; call from main() before audio starts
+void setReverbBinRange(float low_hz, float high_hz)
+{
+    size_t lo = (size_t)(low_hz * N / samplerate + 0.5f);
+    size_t hi = (size_t)(high_hz * N / samplerate + 0.5f);
+    bin_lo = std::min(lo, N / 2);
+    bin_hi = std::max(bin_lo, std::min(hi, N / 2));
+
+    for (size_t i = 0; i < N / 2; i++) {
+        if (i < bin_lo || i >= bin_hi) {
+            reverb_energy[i] = 0.0f;
+        }
+    }
+    for (size_t i = 0; i < band_edge_bins; i++) {
+        band_edge_gain[i] = 0.5f * (1.0f - cos(PI * (i + 1) / (band_edge_bins + 1)));
+    }
+    frozen_amp_valid = false;
+}
+
+// Silences the bins outside the band and tapers the edge bins inside it
+inline void limitBand(float* out_freq)
+{
+    static const size_t offset = N / 2;
+
+    for (size_t i = 0; i < bin_lo; i++) {
+        out_freq[i] = out_freq[i + offset] = 0.0f;
+    }
+    for (size_t i = bin_hi; i < N / 2; i++) {
+        out_freq[i] = out_freq[i + offset] = 0.0f;
+    }
+
+    if (bin_hi - bin_lo < 2 * band_edge_bins) {
+        return;
+    }
+    for (size_t k = 0; k < band_edge_bins; k++) {
+        if (bin_lo > 0) {
+            out_freq[bin_lo + k] *= band_edge_gain[k];
+            out_freq[bin_lo + k + offset] *= band_edge_gain[k];
+        }
+        if (bin_hi < N / 2) {
+            out_freq[bin_hi - 1 - k] *= band_edge_gain[k];
+            out_freq[bin_hi - 1 - k + offset] *= band_edge_gain[k];
+        }
+    }
+}
+
+inline ReverbTier selectTier()
+{
+#if VENUS_TIERED_BINS
+    if (freeze) {
+        return TIER_FREEZE;
+    }
+    if (shimmer_double == 0.0f && shimmer_triple == 0.0f && detune_mode == 1) {
+        return TIER_FAST;
+    }
+#endif
+    return TIER_FULL;
+}
+
+// Amplitude of reverb bin i from its energy, reduced by 1/f above vdamp
+inline float reverbAmp(size_t i)
+{
+    float fft_bin = i + 1;
+    float reverb_amp = sqrt(reverb_energy[i]);
+    if (fft_bin / fft_size > vdamp) {
+        reverb_amp *= vdamp * fft_size/fft_bin;
+    }
+    return reverb_amp;
+}
+
+// Write bin i of the output spectrum with the given amplitude and a random
+// phase. In stereo mode the right spectrum gets the same amplitude with its
+// own random phase, which decorrelates the two channels.
+inline void writeRandomPhase(float reverb_amp, size_t i, float* out_freq, float* out_right)
+{
+    // CRITICAL: Match original - no division by RAND_MAX
+    float random_phase = rand()*2*PI;
+    out_freq[i] = reverb_amp * cos(random_phase);
+    out_freq[i + N / 2] = reverb_amp * sin(random_phase);
+#if VENUS_STEREO
+    float random_phase_r = rand()*2*PI;
+    out_right[i] = reverb_amp * cos(random_phase_r);
+    out_right[i + N / 2] = reverb_amp * sin(random_phase_r);
+#endif
+}
+
+inline void reverbFrozen(float* out_freq, float* out_right)
+{
+    if (!frozen_amp_valid || frozen_amp_damp != vdamp) {
+        for (size_t i = bin_lo; i < bin_hi; i++) {
+            frozen_amp[i] = reverbAmp(i);
         }
+        frozen_amp_damp = vdamp;
+        frozen_amp_valid = true;
+    }
+
+    for (size_t i = bin_lo; i < bin_hi; i++) {
+        writeRandomPhase(frozen_amp[i], i, out_freq, out_right);
+    }
+}
+
+inline void reverbFast(const float* in_freq, float* out_freq, float* out_right)
+{
+    static const size_t offset = N / 2;
+    const float decay_gain = 1.0f - 1.0f/vdecay;
+
+    for (size_t i = bin_lo; i < bin_hi; i++) {
+        float real = in_freq[i];
+        float imag = in_freq[i + offset];
+        float energy = real * real + imag * imag;
+
+        writeRandomPhase(reverbAmp(i), i, out_freq, out_right);
+
+        // Add current energy to reverb, then decay it
+        reverb_energy[i] += energy / laps;  // laps=4 "overlap factor"
+        reverb_energy[i] *= decay_gain;
     }
 }
 
-// Reverb processing function
-inline void reverb(const float* in_freq, float* out_freq)
+inline void reverbFull(const float* in_freq, float* out_freq, float* out_right)
 {
     // convenient constant for grabbing imaginary parts
     static const size_t offset = N / 2;
     
-    for (size_t i = 0; i < N / 2; i++) {
-        float fft_bin = i + 1;
+    for (size_t i = bin_lo; i < bin_hi; i++) {
         float real = in_freq[i];
         float imag = in_freq[i + offset];
         float energy = real * real + imag * imag;
         
-        // Amplitude from energy
-        float reverb_amp = sqrt(reverb_energy[i]);
-        if (fft_bin / fft_size > vdamp) {
-            // Reduce amplitude by 1/f
-            reverb_amp *= vdamp * fft_size/fft_bin;
-        }
-        
         // Add random phase reverb energy
-        // CRITICAL: Match original - no division by RAND_MAX
-        float random_phase = rand()*2*PI;
-        real = reverb_amp * cos(random_phase);
-        imag = reverb_amp * sin(random_phase);
+        writeRandomPhase(reverbAmp(i), i, out_freq, out_right);
         
         // If frozen, don't add new energy or decay the reverb
         if (!freeze) {
@@ -334,12 +571,55 @@ inline void reverb(const float* in_freq, float* out_freq)
                 detune_remainder = 1;
             reverb_energy[i] = detune_remainder * shimmer_remainder * current;
         }
-        
-        out_freq[i] = real;
-        out_freq[i + offset] = imag;
+    }
+
+    // Drop energy that shimmer/detune spread outside the band
+    for (size_t i = 0; i < bin_lo; i++) {
+        reverb_energy[i] = 0.0f;
+    }
+    for (size_t i = bin_hi; i < N / 2; i++) {
+        reverb_energy[i] = 0.0f;
     }
 }
 
+// Reverb processing function. out_right is only written in stereo mode.
+inline void reverbChannels(const float* in_freq, float* out_freq, float* out_right)
+{
+    ReverbTier tier = selectTier();
+
+    if (tier != TIER_FREEZE) {
+        frozen_amp_valid = false;
+    }
+
+    switch (tier) {
+        case TIER_FREEZE:
+            reverbFrozen(out_freq, out_right);
+            break;
+        case TIER_FAST:
+            reverbFast(in_freq, out_freq, out_right);
+            break;
+        case TIER_FULL:
+            reverbFull(in_freq, out_freq, out_right);
+            break;
+    }
+
+    if (bin_lo > 0 || bin_hi < N / 2) {
+        limitBand(out_freq);
+#if VENUS_STEREO
+        limitBand(out_right);
+#endif
+    }
+}
+
+void reverb(const float* in_freq, float* const* out_freq)
+{
+#if VENUS_STEREO
+    reverbChannels(in_freq, out_freq[0], out_freq[1]);
+#else
+    reverbChannels(in_freq, out_freq[0], nullptr);
+#endif
+}
+
 int main(void)
 {
     hw.Init();
@@ -347,10 +627,21 @@ int main(void)
     samplerate = hw.AudioSampleRate();
     hw.SetAudioBlockSize(256);  // Matching original
     
-    // Initialize reverb energy array
+    // Initialize reverb energy and STFT arrays
+    // (required: DTCM, D2 and SDRAM placements are not zeroed at startup)
     for (size_t i = 0; i < N / 2; i++) {
         reverb_energy[i] = 0.0;
     }
+    memset(in, 0, sizeof(in));
+    memset(middle, 0, sizeof(middle));
+    memset(out, 0, sizeof(out));
+#if VENUS_COMPACT_BUFFERS
+    memset(frame, 0, sizeof(frame));
+#endif
+#if VENUS_STEREO
+    memset(in_r, 0, sizeof(in_r));
+    memset(out_r, 0, sizeof(out_r));
+#endif
     
     // Initialize toggle positions to unknown
     prev_toggle1_pos = Hothouse::TOGGLESWITCH_UNKNOWN;
@@ -366,16 +657,37 @@ int main(void)
     // Set initial bypass state
     bypass = true;
     
+    // Processed band (full range unless built with VENUS_GUITAR_RANGE=1)
+    if (VENUS_GUITAR_RANGE) {
+        setReverbBinRange(guitar_range_low_hz, guitar_range_high_hz);
+    } else {
+        setReverbBinRange(0.0f, samplerate / 2);
+    }
+    
     // Initialize FFT and STFT objects
-    fft = new ShyFFT<float, N, RotationPhasor>();
-    fft->Init();
-    stft = new Fourier<float, N>(reverb, fft, &hann, laps, in, middle, out);
+    fft.Init();
+#if VENUS_STEREO
+    const std::array<stft_sample*, channels> stft_in = {{in, in_r}};
+    const std::array<float*, channels> stft_out = {{out, out_r}};
+#else
+    const std::array<stft_sample*, channels> stft_in = {{in}};
+    const std::array<float*, channels> stft_out = {{out}};
+#endif
+#if VENUS_COMPACT_BUFFERS
+    stft = new Stft(reverb, &fft, &hann, laps, stft_in, middle, stft_out, frame);
+#else
+    stft = new Stft(reverb, &fft, &hann, laps, stft_in, middle, stft_out);
+#endif
     
     // Initialize audio processing objects
     samplerateReducer.Init();
     samplerateReducer.SetFreq(0.3);
     lowpass.Init(samplerate);
     lowpass.SetFreq(8000.0);
+    samplerateReducer_r.Init();
+    samplerateReducer_r.SetFreq(0.3);
+    lowpass_r.Init(samplerate);
+    lowpass_r.SetFreq(8000.0);
     
     // Initialize drift oscillators
     drift_osc.Init(samplerate);
@@ -395,16 +707,31 @@ int main(void)
     vshimmer_tone = 0.0;
     vdetune = 0.0;
     
+#ifdef VENUS_BENCHMARK
+    hw.seed.StartLog(false);
+    cpu_meter.Init(hw.AudioSampleRate(), hw.AudioBlockSize());
+    uint32_t last_report = System::GetNow();
+#endif
+
     hw.StartAdc();
     hw.StartAudio(AudioCallback);
     
     while(1) {
         // Check for Hothouse built-in DFU entry method
         hw.CheckResetToBootloader();
+
+#ifdef VENUS_BENCHMARK
+        if (System::GetNow() - last_report >= 1000) {
+            last_report = System::GetNow();
+            hw.seed.PrintLine("CPU avg: " FLT_FMT3 "%% max: " FLT_FMT3 "%%",
+                              FLT_VAR3(cpu_meter.GetAvgCpuLoad() * 100.0f),
+                              FLT_VAR3(cpu_meter.GetMaxCpuLoad() * 100.0f));
+            cpu_meter.Reset();
+        }
+#endif
         
         hw.DelayMs(1);
     }
     
     delete stft;
-    delete fft;
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+# OctaveDSP - header-only octave and multirate DSP shared by the octave ports
+#
+# Include it from a port Makefile, after the libDaisy core Makefile:
+#   OCTAVE_DSP_DIR = ../../../OctaveDSP
+#   include $(OCTAVE_DSP_DIR)/OctaveDSP.mk
+#
+# The headers are then found as "Util/OctaveGenerator.h" and so on.
+# OctaveGenerator.h needs gcem (-I.../gcem/include), which the port provides.
+
+OCTAVE_DSP_DIR ?= $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+
+C_INCLUDES += -I$(OCTAVE_DSP_DIR)
@@ -7,12 +7,11 @@
 #include "FastSqrt.h"
 
 //=============================================================================
-class BandShifter
+// Filter coefficients for one band, shared by BandShifter and
+// BandShifterBank so both run the exact same filter
+struct BandShifterCoefficients
 {
-public:
-    BandShifter() = default;
-
-    BandShifter(float center, float sample_rate, float bw)
+    BandShifterCoefficients(float center, float sample_rate, float bw)
     {
         constexpr auto pi = std::numbers::pi_v<double>;
         constexpr auto j = std::complex<double>(0, 1);
@@ -28,17 +27,35 @@ public:
         const auto e1 = std::exp(j * w1);
         const auto e2 = std::exp(j * w1 * 2.0);
 
-        const auto d0 = g;
-        const auto d1 = e1 * 2.0 * g;
-        const auto d2 = e2 * g;
-        const auto c1 = e1 * (-2 * cos_w0) / a0;
-        const auto c2 = e2 * (1 - sqrt_2 * sin_w0 / 2) / a0;
-
-        _d0 = d0;
-        _d1 = std::complex<float>(d1.real(), d1.imag());
-        _d2 = std::complex<float>(d2.real(), d2.imag());
-        _c1 = std::complex<float>(c1.real(), c1.imag());
-        _c2 = std::complex<float>(c2.real(), c2.imag());
+        // Worked out in double, stored in float
+        d0 = static_cast<float>(g);
+        d1 = std::complex<float>(e1 * 2.0 * g);
+        d2 = std::complex<float>(e2 * g);
+        c1 = std::complex<float>(e1 * (-2 * cos_w0) / a0);
+        c2 = std::complex<float>(e2 * (1 - sqrt_2 * sin_w0 / 2) / a0);
+    }
+
+    float d0;
+    std::complex<float> d1;
+    std::complex<float> d2;
+    std::complex<float> c1;
+    std::complex<float> c2;
+};
+
+//=============================================================================
+class BandShifter
+{
+public:
+    BandShifter() = default;
+
+    BandShifter(float center, float sample_rate, float bw)
+    {
+        const BandShifterCoefficients k(center, sample_rate, bw);
+        _d0 = k.d0;
+        _d1 = k.d1;
+        _d2 = k.d2;
+        _c1 = k.c1;
+        _c2 = k.c2;
     }
 
     void update(float sample)
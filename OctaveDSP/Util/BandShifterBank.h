@@ -0,0 +1,590 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "BandShifter.h"
+#include "FastSqrt.h"
+
+//=============================================================================
+// Phase scaling kernels for BandShifterBank::setQuality()
+enum class ShifterQuality
+{
+    // BandShifter's math: normalize each band signal to unit magnitude,
+    // then square it or rotate it by the half angle. Six inverse square
+    // roots per band.
+    reference,
+
+    // Half-angle formulas that work on the magnitude alone (see shiftFast).
+    // Three inverse square roots per band, and closer to exact math than
+    // the reference because fewer approximations feed into each other.
+    fast,
+
+    // As fast, with a second Newton step on the two inverse square roots
+    // that set the output magnitudes
+    high
+};
+
+//=============================================================================
+// A bank of BandShifters stored as a structure of arrays.
+//
+// Every band runs the same filter and phase scaling as BandShifter, but the
+// state and coefficients of all bands live in contiguous float arrays and
+// tight loops step all bands through each stage together. With no complex<>
+// objects or per-band calls in the way, the compiler can vectorize the loops
+// on the host and software-pipeline it on the Cortex-M7, whose FPU has no
+// float SIMD for CMSIS-DSP to exploit.
+//
+// With the reference kernel, the summed up1/down1/down2 outputs match a
+// std::vector<BandShifter> fed the same samples, up to float summation
+// order when -ffast-math lets the compiler reorder the sums.
+//
+// Optionally, bands with no signal can sleep (setSleepThreshold). A sleeping
+// band keeps running its filter, energy follower and octave-down sign
+// tracking, which are cheap, but skips the phase scaling, which is most of
+// the per-band cost. Bands fade out when they go to sleep and fade back in
+// when they wake up, so gating doesn't click.
+//
+// setQuality() picks the phase scaling kernel; see ShifterQuality.
+template <std::size_t Bands>
+class BandShifterBank
+{
+public:
+    static constexpr std::size_t size = Bands;
+    static_assert(Bands <= 256, "band indices are stored as uint8_t");
+
+    void setBand(std::size_t n, float center, float sample_rate, float bw)
+    {
+        _energy_coeff = 1 - std::exp(-1 / (energy_time * sample_rate));
+        _fade_step = 1 / (fade_time * sample_rate);
+
+        const BandShifterCoefficients k(center, sample_rate, bw);
+        _d0[n] = k.d0;
+        _d1_re[n] = k.d1.real();
+        _d1_im[n] = k.d1.imag();
+        _d2_re[n] = k.d2.real();
+        _d2_im[n] = k.d2.imag();
+        _c1_re[n] = k.c1.real();
+        _c1_im[n] = k.c1.imag();
+        _c2_re[n] = k.c2.real();
+        _c2_im[n] = k.c2.imag();
+
+        _s1_re[n] = _s1_im[n] = 0;
+        _s2_re[n] = _s2_im[n] = 0;
+        _y_re[n] = _y_im[n] = 0;
+        _down1_re[n] = _down1_im[n] = 0;
+        _down1_sign[n] = 1;
+        _down2_sign[n] = 1;
+        _energy[n] = 0;
+        _gain[n] = 1;
+    }
+
+    // Bands whose level stays below `level` (linear amplitude of the band
+    // signal, e.g. 0.0001 for -80 dB) go to sleep. 0 disables gating.
+    void setSleepThreshold(float level)
+    {
+        _wake_energy = level * level;
+        _sleep_energy = _wake_energy * 0.25f; // 6 dB of hysteresis
+        if (level <= 0)
+        {
+            _gain.fill(1);
+        }
+    }
+
+    // Clears the band state (not the coefficients or settings), as if the
+    // input had been silent for a long time: filters at rest, and with
+    // gating on, every band asleep.
+    void reset()
+    {
+        for (Lane* lane : {&_s1_re, &_s1_im, &_s2_re, &_s2_im, &_y_re, &_y_im,
+                           &_down1_re, &_down1_im, &_mag2, &_energy})
+        {
+            lane->fill(0);
+        }
+        _down1_sign.fill(1);
+        _down2_sign.fill(1);
+        _gain.fill((_wake_energy > 0) ? 0 : 1);
+        _sum_up1 = _sum_down1 = _sum_down2 = 0;
+        _up1 = _down1 = _down2 = 0;
+    }
+
+    // Number of bands that ran the phase scaling on the last update
+    std::size_t awakeBands() const
+    {
+        return _num_awake;
+    }
+
+    // Only bands [0, count) are processed and summed
+    void setActiveBands(std::size_t count)
+    {
+        _active = (count < Bands) ? count : Bands;
+    }
+
+    std::size_t activeBands() const
+    {
+        return _active;
+    }
+
+    void setQuality(ShifterQuality quality)
+    {
+        _quality = quality;
+    }
+
+    ShifterQuality quality() const
+    {
+        return _quality;
+    }
+
+    void update(float sample)
+    {
+        begin(sample);
+        updateBands(0, _active);
+        end();
+    }
+
+    // Incremental form of update(), for spreading the work over several
+    // calls: begin(sample), then updateBands() over consecutive ranges that
+    // together cover [0, activeBands()), then end(). Gives the same outputs
+    // as update().
+    void begin(float sample)
+    {
+        _sample = sample;
+        _sum_up1 = 0;
+        _sum_down1 = 0;
+        _sum_down2 = 0;
+        _num_awake = 0;
+    }
+
+    void updateBands(std::size_t first, std::size_t last)
+    {
+        switch (_quality)
+        {
+        case ShifterQuality::fast:
+            updateBands<ShifterQuality::fast>(first, last);
+            break;
+        case ShifterQuality::high:
+            updateBands<ShifterQuality::high>(first, last);
+            break;
+        default:
+            updateBands<ShifterQuality::reference>(first, last);
+            break;
+        }
+    }
+
+    void end()
+    {
+        _up1 = _sum_up1;
+        _down1 = _sum_down1;
+        _down2 = _sum_down2;
+    }
+
+    // Block form of update(): runs `count` samples from `in` and writes the
+    // summed outputs for each to up1, down1 and down2 (which must not overlap
+    // `in`). Each band runs through the whole block before the next, so its
+    // state stays in registers instead of being reloaded for every sample.
+    // Gives the same outputs as calling update() per sample.
+    void process(const float* in, std::size_t count,
+                 float* up1, float* down1, float* down2)
+    {
+        switch (_quality)
+        {
+        case ShifterQuality::fast:
+            process<ShifterQuality::fast>(in, count, up1, down1, down2);
+            break;
+        case ShifterQuality::high:
+            process<ShifterQuality::high>(in, count, up1, down1, down2);
+            break;
+        default:
+            process<ShifterQuality::reference>(in, count, up1, down1, down2);
+            break;
+        }
+    }
+
+    float up1() const
+    {
+        return _up1;
+    }
+
+    float down1() const
+    {
+        return _down1;
+    }
+
+    float down2() const
+    {
+        return _down2;
+    }
+
+private:
+    template <ShifterQuality Quality>
+    void updateBands(std::size_t first, std::size_t last)
+    {
+        const float sample = _sample;
+
+#if defined(__arm__)
+#pragma GCC unroll 4
+#endif
+        for (std::size_t n = first; n < last; ++n)
+        {
+            updateFilter(n, sample);
+        }
+
+        float up1 = _sum_up1;
+        float down1 = _sum_down1;
+        float down2 = _sum_down2;
+
+        if (_wake_energy <= 0)
+        {
+#if defined(__arm__)
+#pragma GCC unroll 4
+#endif
+            for (std::size_t n = first; n < last; ++n)
+            {
+                shift<Quality>(n, up1, down1, down2);
+            }
+            _num_awake += last - first;
+        }
+        else
+        {
+            std::size_t num_awake = 0;
+            for (std::size_t n = first; n < last; ++n)
+            {
+                _gain[n] = updateGain(_energy[n], _gain[n]);
+                if (_gain[n] > 0)
+                {
+                    _awake[num_awake++] = static_cast<std::uint8_t>(n);
+                }
+            }
+
+            for (std::size_t i = 0; i < num_awake; ++i)
+            {
+                const std::size_t n = _awake[i];
+                float band_up1 = 0;
+                float band_down1 = 0;
+                float band_down2 = 0;
+                shift<Quality>(n, band_up1, band_down1, band_down2);
+                up1 += _gain[n] * band_up1;
+                down1 += _gain[n] * band_down1;
+                down2 += _gain[n] * band_down2;
+            }
+            _num_awake += num_awake;
+        }
+
+        _sum_up1 = up1;
+        _sum_down1 = down1;
+        _sum_down2 = down2;
+    }
+
+    template <ShifterQuality Quality>
+    void process(const float* in, std::size_t count,
+                 float* up1, float* down1, float* down2)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::fill_n(up1, count, 0.0f);
+        std::fill_n(down1, count, 0.0f);
+        std::fill_n(down2, count, 0.0f);
+
+        const std::size_t active = _active;
+        const bool gated = _wake_energy > 0;
+        std::size_t num_awake = 0;
+
+        for (std::size_t n = 0; n < active; ++n)
+        {
+            Band b = load(n);
+
+            if (!gated)
+            {
+                for (std::size_t t = 0; t < count; ++t)
+                {
+                    updateFilter(b, in[t]);
+                    shift<Quality>(b, up1[t], down1[t], down2[t]);
+                }
+            }
+            else
+            {
+                for (std::size_t t = 0; t < count; ++t)
+                {
+                    updateFilter(b, in[t]);
+                    b.gain = updateGain(b.energy, b.gain);
+                    if (b.gain > 0)
+                    {
+                        float band_up1 = 0;
+                        float band_down1 = 0;
+                        float band_down2 = 0;
+                        shift<Quality>(b, band_up1, band_down1, band_down2);
+                        up1[t] += b.gain * band_up1;
+                        down1[t] += b.gain * band_down1;
+                        down2[t] += b.gain * band_down2;
+                    }
+                }
+                num_awake += (b.gain > 0);
+            }
+
+            store(n, b);
+        }
+
+        _num_awake = gated ? num_awake : active;
+        _up1 = up1[count - 1];
+        _down1 = down1[count - 1];
+        _down2 = down2[count - 1];
+    }
+
+    // One band's coefficients and state, loaded from the lanes into locals
+    struct Band
+    {
+        float d0, d1_re, d1_im, d2_re, d2_im, c1_re, c1_im, c2_re, c2_im;
+        float s1_re, s1_im, s2_re, s2_im, y_re, y_im;
+        float down1_re, down1_im, down1_sign, down2_sign;
+        float mag2, energy, energy_coeff, gain;
+    };
+
+    Band load(std::size_t n) const
+    {
+        return {
+            _d0[n], _d1_re[n], _d1_im[n], _d2_re[n], _d2_im[n],
+            _c1_re[n], _c1_im[n], _c2_re[n], _c2_im[n],
+            _s1_re[n], _s1_im[n], _s2_re[n], _s2_im[n], _y_re[n], _y_im[n],
+            _down1_re[n], _down1_im[n], _down1_sign[n], _down2_sign[n],
+            _mag2[n], _energy[n], _energy_coeff, _gain[n]
+        };
+    }
+
+    // Writes back the state (the coefficients don't change)
+    void store(std::size_t n, const Band& b)
+    {
+        _s1_re[n] = b.s1_re;
+        _s1_im[n] = b.s1_im;
+        _s2_re[n] = b.s2_re;
+        _s2_im[n] = b.s2_im;
+        _y_re[n] = b.y_re;
+        _y_im[n] = b.y_im;
+        _down1_re[n] = b.down1_re;
+        _down1_im[n] = b.down1_im;
+        _down1_sign[n] = b.down1_sign;
+        _down2_sign[n] = b.down2_sign;
+        _mag2[n] = b.mag2;
+        _energy[n] = b.energy;
+        _gain[n] = b.gain;
+    }
+
+    void updateFilter(std::size_t n, float sample)
+    {
+        Band b = load(n);
+        updateFilter(b, sample);
+        store(n, b);
+    }
+
+    template <ShifterQuality Quality>
+    void shift(std::size_t n, float& up1, float& down1, float& down2)
+    {
+        Band b = load(n);
+        shift<Quality>(b, up1, down1, down2);
+        store(n, b);
+    }
+
+    template <ShifterQuality Quality>
+    static void shift(Band& b, float& up1, float& down1, float& down2)
+    {
+        if constexpr (Quality == ShifterQuality::reference)
+        {
+            shiftReference(b, up1, down1, down2);
+        }
+        else
+        {
+            shiftFast<Quality == ShifterQuality::high>(b, up1, down1, down2);
+        }
+    }
+
+    // Complex filter (see BandShifter::update_filter), plus the band energy
+    // and octave-down sign tracking that have to run even while asleep
+    static void updateFilter(Band& b, float sample)
+    {
+        const float prev_y_im = b.y_im;
+        const float y_re = b.s2_re + b.d0*sample;
+        const float y_im = b.s2_im;
+        const float c1_y_re = b.c1_re*y_re - b.c1_im*y_im;
+        const float c1_y_im = b.c1_re*y_im + b.c1_im*y_re;
+        const float c2_y_re = b.c2_re*y_re - b.c2_im*y_im;
+        const float c2_y_im = b.c2_re*y_im + b.c2_im*y_re;
+
+        b.s2_re = (b.s1_re + b.d1_re*sample) - c1_y_re;
+        b.s2_im = (b.s1_im + b.d1_im*sample) - c1_y_im;
+        b.s1_re = b.d2_re*sample - c2_y_re;
+        b.s1_im = b.d2_im*sample - c2_y_im;
+        b.y_re = y_re;
+        b.y_im = y_im;
+
+        const bool flip1 = (y_re < 0) &&
+            (std::signbit(y_im) != std::signbit(prev_y_im));
+        b.down1_sign = flip1 ? -b.down1_sign : b.down1_sign;
+
+        const float mag2 = y_re*y_re + y_im*y_im;
+        b.mag2 = mag2;
+        b.energy += b.energy_coeff * (mag2 - b.energy);
+    }
+
+    // Phase scaling for one band; adds the band's outputs to the sums
+    static void shiftReference(Band& b, float& up1, float& down1, float& down2)
+    {
+        const float y_re = b.y_re;
+        const float y_im = b.y_im;
+        const float mag2 = b.mag2;
+
+        // Octave up (see BandShifter::update_up1)
+        up1 += (y_re*y_re - y_im*y_im) * fastInvSqrt(mag2);
+
+        // Octave down (see BandShifter::update_down1)
+        const float x1 = 0.5f * y_re * fastInvSqrt(mag2);
+        const float c1 = fastSqrt(0.5f + x1);
+        const float d1 = ((y_im < 0) ? -1.0f : 1.0f) * fastSqrt(0.5f - x1);
+        const float prev_down1_im = b.down1_im;
+        const float down1_re = b.down1_sign * (y_re*c1 + y_im*d1);
+        const float down1_im = b.down1_sign * (y_im*c1 - y_re*d1);
+        b.down1_re = down1_re;
+        b.down1_im = down1_im;
+        down1 += down1_re;
+
+        const bool flip2 = (down1_re < 0) &&
+            (std::signbit(down1_im) != std::signbit(prev_down1_im));
+        const float down2_sign = flip2 ? -b.down2_sign : b.down2_sign;
+        b.down2_sign = down2_sign;
+
+        // Two octaves down (see BandShifter::update_down2)
+        const float x2 = 0.5f * down1_re *
+            fastInvSqrt(down1_re*down1_re + down1_im*down1_im);
+        const float c2 = fastSqrt(0.5f + x2);
+        const float d2 = ((down1_im < 0) ? -1.0f : 1.0f) * fastSqrt(0.5f - x2);
+        down2 += down2_sign * (down1_re*c2 + down1_im*d2);
+    }
+
+    // Same outputs as shiftReference, without normalizing anything. With
+    // y = a + ib and r = |y|:
+    //
+    //   up1   = Re(y^2) / r = (a^2 - b^2) / r
+    //   down1 = r e^(i arg(y)/2), the square root of y scaled back up to
+    //           magnitude r. Its larger component is sqrt(r (r + |a|) / 2)
+    //           and the other is r |b| / (2 * larger), so one inverse square
+    //           root gives both without cancellation near the negative axis.
+    //   down2 = Re of the same on down1. |down1| = r, so only the real part
+    //           sqrt(r (r + Re down1) / 2) is needed.
+    //
+    // Refine adds a Newton step to the inverse square roots of r^2 and of
+    // the larger down1 component; the last square root only feeds down2's
+    // magnitude and is left at one step.
+    template <bool Refine>
+    static void shiftFast(Band& b, float& up1, float& down1, float& down2)
+    {
+        const float y_re = b.y_re;
+        const float y_im = b.y_im;
+        const float mag2 = b.mag2;
+
+        const float inv_r = invSqrt<Refine>(mag2);
+        const float r = mag2 * inv_r;
+
+        // Octave up
+        up1 += (y_re*y_re - y_im*y_im) * inv_r;
+
+        // Octave down
+        const float big2 = 0.5f * r * (r + std::fabs(y_re));
+        const float inv_big = invSqrt<Refine>(big2);
+        const float big = big2 * inv_big;
+        const float small = 0.5f * r * std::fabs(y_im) * inv_big;
+        const float half_re = (y_re < 0) ? small : big;
+        const float half_im = (y_re < 0) ? big : small;
+        const float prev_down1_im = b.down1_im;
+        const float down1_re = b.down1_sign * half_re;
+        const float down1_im = b.down1_sign * ((y_im < 0) ? -half_im : half_im);
+        b.down1_re = down1_re;
+        b.down1_im = down1_im;
+        down1 += down1_re;
+
+        const bool flip2 = (down1_re < 0) &&
+            (std::signbit(down1_im) != std::signbit(prev_down1_im));
+        const float down2_sign = flip2 ? -b.down2_sign : b.down2_sign;
+        b.down2_sign = down2_sign;
+
+        // Two octaves down
+        down2 += down2_sign * fastSqrt(std::max(0.5f * r * (r + down1_re), 0.0f));
+    }
+
+    template <bool Refine>
+    static float invSqrt(float x)
+    {
+        if constexpr (Refine)
+        {
+            // Keeps y*y finite for silent bands
+            x = std::max(x, 1e-30f);
+            const float y = fastInvSqrt(x);
+            return y * (1.5f - 0.5f * x * y * y);
+        }
+        return fastInvSqrt(x);
+    }
+
+    // Sleep gating: fades the band's gain towards 1 while it has signal and
+    // towards 0 once it goes quiet
+    float updateGain(float energy, float gain) const
+    {
+        if (energy > _wake_energy)
+        {
+            return std::min(gain + _fade_step, 1.0f);
+        }
+        if (energy < _sleep_energy)
+        {
+            return std::max(gain - _fade_step, 0.0f);
+        }
+        // Between the thresholds: keep fading in if awake
+        return (gain > 0) ? std::min(gain + _fade_step, 1.0f) : gain;
+    }
+
+    static constexpr float energy_time = 0.01f; // energy follower, seconds
+    static constexpr float fade_time = 0.005f; // sleep/wake fade, seconds
+
+    using Lane = std::array<float, Bands>;
+
+    // Coefficients
+    Lane _d0{};
+    Lane _d1_re{}, _d1_im{};
+    Lane _d2_re{}, _d2_im{};
+    Lane _c1_re{}, _c1_im{};
+    Lane _c2_re{}, _c2_im{};
+
+    // State
+    Lane _s1_re{}, _s1_im{};
+    Lane _s2_re{}, _s2_im{};
+    Lane _y_re{}, _y_im{};
+    Lane _down1_re{}, _down1_im{};
+    Lane _down1_sign{};
+    Lane _down2_sign{};
+    Lane _mag2{};
+
+    // Sleep gating
+    Lane _energy{};
+    Lane _gain{};
+    std::array<std::uint8_t, Bands> _awake{};
+    float _energy_coeff = 1;
+    float _fade_step = 1;
+    float _wake_energy = 0;
+    float _sleep_energy = 0;
+    std::size_t _num_awake = Bands;
+
+    std::size_t _active = Bands;
+    ShifterQuality _quality = ShifterQuality::reference;
+
+    // Running sums between begin() and end()
+    float _sample = 0;
+    float _sum_up1 = 0;
+    float _sum_down1 = 0;
+    float _sum_down2 = 0;
+
+    float _up1 = 0;
+    float _down1 = 0;
+    float _down2 = 0;
+};
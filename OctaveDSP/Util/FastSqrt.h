@@ -0,0 +1,52 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// std::bit_cast, or memcpy on standard libraries older than GCC 11's (such
+// as the GCC 10 Arm toolchain), which is just as well defined but isn't
+// usable in constant expressions
+template <typename To, typename From>
+constexpr To bitCast(const From& from) noexcept
+{
+    static_assert(sizeof(To) == sizeof(From));
+#if defined(__cpp_lib_bit_cast)
+    return std::bit_cast<To>(from);
+#else
+    To to;
+    std::memcpy(&to, &from, sizeof(To));
+    return to;
+#endif
+}
+
+// https://en.wikipedia.org/wiki/Fast_inverse_square_root
+static constexpr float fastInvSqrt(float number) noexcept
+{
+    static_assert(std::numeric_limits<float>::is_iec559);
+
+    const float threehalfs = 1.5F;
+
+    const float x2 = number * 0.5F;
+
+    // evil floating point bit level hacking (32 bits on both ARM and host)
+    std::int32_t i = bitCast<std::int32_t>(number);
+
+    // value is pre-assumed
+    i = 0x5f3759df - (i >> 1);
+    float y = bitCast<float>(i);
+
+    // 1st iteration
+    y = y * (threehalfs - (x2 * y * y));
+
+    // 2nd iteration, this can be removed
+    // y = y * (threehalfs - (x2 * y * y));
+
+    return y;
+}
+
+static constexpr float fastSqrt(float x)
+{
+    return fastInvSqrt(x) * x;
+}
@@ -0,0 +1,610 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+constexpr size_t resample_factor = 6;
+//constexpr size_t resample_factor = 1; // KAB Note: redefining as 1 to get around DaisySeedProjects effects being set up to process every sample, not every block
+                                      // Not sure what this will do TODO
+
+// Most low-rate samples MultirateScheduler passes to one Stage::process() call
+constexpr size_t max_low_rate_block = 64;
+
+//=============================================================================
+// History of the last Size samples in a doubled linear buffer: every sample
+// is written twice, Size apart, so the window [pos, pos + Size) is always
+// contiguous and reads need no wrap-around or masking. x(0) is the newest
+// sample, x(Size-1) the oldest.
+template <std::size_t Size>
+class HistoryBuffer
+{
+public:
+    static constexpr std::size_t size = Size;
+
+    void push(float s)
+    {
+        pos = (pos == 0) ? Size - 1 : pos - 1;
+        buffer[pos] = s;
+        buffer[pos + Size] = s;
+    }
+
+    float operator()(std::size_t i) const
+    {
+        return buffer[pos + i];
+    }
+
+private:
+    std::array<float, 2 * Size> buffer{};
+    std::size_t pos = 0;
+};
+
+
+//=============================================================================
+// Decimates by Ratio with a symmetric (linear phase) FIR of Taps taps.
+//
+// Only every Ratio'th output is computed, and the symmetric taps are folded
+// so each coefficient pair costs one multiply. The filter is given as the
+// first (Taps + 1) / 2 coefficients of the prototype.
+//
+// The folded sum has `terms` terms: term i is h[i] * (x[i] + x[Taps-1-i]),
+// and for odd Taps the last term is the center tap. fold() evaluates any
+// range of them, so the work for one output can be split over the input
+// samples that follow its newest one (see Decimator2::push).
+template <std::size_t Ratio, std::size_t Taps>
+class PolyphaseDecimator
+{
+public:
+    static constexpr std::size_t ratio = Ratio;
+    static constexpr std::size_t taps = Taps;
+    static constexpr std::size_t terms = (Taps + 1) / 2;
+
+    explicit constexpr PolyphaseDecimator(const std::array<float, terms>& half)
+      : h(half)
+    {
+    }
+
+    float operator()(std::span<const float, Ratio> s)
+    {
+        for (float x : s)
+        {
+            push(x);
+        }
+        return output();
+    }
+
+    void push(float s)
+    {
+        history.push(s);
+    }
+
+    // Output for the newest sample
+    float output() const
+    {
+        return fold<0, terms, 0>(0);
+    }
+
+    // Adds terms [First, Last) of the output for the sample pushed Late
+    // samples ago to `sum`
+    template <std::size_t First, std::size_t Last, std::size_t Late>
+    float fold(float sum) const
+    {
+        static_assert(First <= Last && Last <= terms && Late < Ratio);
+
+        if constexpr (First < Last)
+        {
+            constexpr std::size_t i = First;
+            if constexpr (2 * i + 1 == Taps)
+            {
+                sum += h[i] * history(Late + i);
+            }
+            else
+            {
+                sum += h[i] * (history(Late + i) + history(Late + Taps - 1 - i));
+            }
+            return fold<First + 1, Last, Late>(sum);
+        }
+        return sum;
+    }
+
+private:
+    std::array<float, terms> h;
+    HistoryBuffer<Taps + Ratio - 1> history;
+};
+
+
+//=============================================================================
+// Interpolates by Ratio with a symmetric (linear phase) FIR of Taps taps.
+//
+// The prototype is split into Ratio polyphase branches, so the zeros that
+// upsampling would insert are never multiplied. Output p of each input
+// sample uses branch h[p], h[p + Ratio], ... (which includes the Ratio
+// gain). Branches that are symmetric themselves are folded. The filter is
+// given as the first (Taps + 1) / 2 coefficients of the prototype.
+template <std::size_t Ratio, std::size_t Taps>
+class PolyphaseInterpolator
+{
+public:
+    static constexpr std::size_t ratio = Ratio;
+    static constexpr std::size_t taps = Taps;
+    static constexpr std::size_t branch_taps = (Taps + Ratio - 1) / Ratio;
+
+    explicit constexpr PolyphaseInterpolator(
+        const std::array<float, (Taps + 1) / 2>& half)
+    {
+        for (std::size_t p = 0; p < Ratio; ++p)
+        {
+            for (std::size_t k = p, i = 0; k < Taps; k += Ratio, ++i)
+            {
+                branches[p][i] = (k < half.size()) ? half[k] : half[Taps - 1 - k];
+            }
+        }
+    }
+
+    std::array<float, Ratio> operator()(float s)
+    {
+        push(s);
+        return outputs(std::make_index_sequence<Ratio>());
+    }
+
+    void push(float s)
+    {
+        history.push(s);
+    }
+
+    // Output Phase (0 to Ratio-1) for the newest sample
+    template <std::size_t Phase>
+    float output() const
+    {
+        static_assert(Phase < Ratio);
+
+        constexpr std::size_t n = (Taps - Phase + Ratio - 1) / Ratio;
+        constexpr bool folded = (Taps - 1 - 2 * Phase == Ratio * (n - 1));
+
+        constexpr std::size_t terms = folded ? (n + 1) / 2 : n;
+        return branch<Phase, folded, n>(std::make_index_sequence<terms>());
+    }
+
+private:
+    template <std::size_t... Phase>
+    std::array<float, Ratio> outputs(std::index_sequence<Phase...>) const
+    {
+        return {output<Phase>()...};
+    }
+
+    // Sum of the terms of branch Phase, in order. A folded branch of length
+    // N pairs tap I with tap N-1-I (the center tap stands alone).
+    template <std::size_t Phase, bool Folded, std::size_t N, std::size_t... I>
+    float branch(std::index_sequence<I...>) const
+    {
+        float sum = 0;
+        ((sum += term<Phase, Folded, N, I>()), ...);
+        return sum;
+    }
+
+    template <std::size_t Phase, bool Folded, std::size_t N, std::size_t I>
+    float term() const
+    {
+        const float c = branches[Phase][I];
+        if constexpr (Folded && 2 * I + 1 != N)
+        {
+            return c * (history(I) + history(N - 1 - I));
+        }
+        else
+        {
+            return c * history(I);
+        }
+    }
+
+    std::array<std::array<float, branch_taps>, Ratio> branches{};
+    HistoryBuffer<branch_taps> history;
+};
+
+
+//=============================================================================
+// 48000 Hz -> 8000 Hz, as decimate by 3 then decimate by 2
+class Decimator2
+{
+public:
+    float operator()(std::span<const float, resample_factor> s)
+    {
+        stage1.push(s[0]);
+        const float a = stage1.output();
+        stage1.push(s[1]);
+        stage1.push(s[2]);
+        stage1.push(s[3]);
+        const float b = stage1.output();
+        stage1.push(s[4]);
+        stage1.push(s[5]);
+
+        stage2.push(a);
+        out = stage2.output();
+        stage2.push(b);
+
+        return out;
+    }
+
+    // Block form: decimates `count` full-rate samples (any count; a partial
+    // period carries over to the next call) and returns how many low-rate
+    // samples were written to `low_rate`. It goes through push() for partial
+    // periods, so calls can be freely mixed with push(), and with
+    // operator() at a period boundary.
+    std::size_t process(const float* in, std::size_t count, float* low_rate)
+    {
+        std::size_t produced = 0;
+        std::size_t i = 0;
+
+        // Finish a partial period, run whole ones in one go, then start the
+        // next partial one
+        for (; i < count && phase != 0; ++i)
+        {
+            if (push(in[i]))
+            {
+                low_rate[produced++] = output();
+            }
+        }
+        for (; i + resample_factor <= count; i += resample_factor)
+        {
+            low_rate[produced++] = (*this)(std::span<const float, resample_factor>(
+                in + i, resample_factor));
+        }
+        for (; i < count; ++i)
+        {
+            push(in[i]);
+        }
+
+        return produced;
+    }
+
+    // Incremental form of operator(): takes one full-rate sample at a time
+    // and returns true on every resample_factor'th sample, when output() has
+    // the new low-rate sample. Each FIR output is summed in slices over the
+    // samples that follow its newest input, so no one sample does all of
+    // the work. Gives the same outputs as operator(). The two forms can only
+    // take turns at a period boundary, after push() has returned true: in
+    // the middle of a period, operator() would drop the slices push() still
+    // owes.
+    bool push(float s)
+    {
+        stage1.push(s);
+
+        switch (phase)
+        {
+            // First stage 1 output, for the sample of phase 0
+            case 0: acc1 = stage1.fold<0, 4, 0>(0); break;
+            case 1: acc1 = stage1.fold<4, 8, 1>(acc1); break;
+            case 2:
+                stage2.push(stage1.fold<8, 11, 2>(acc1));
+                acc2 = stage2.fold<0, 3, 0>(0);
+                break;
+
+            // Second stage 1 output, for the sample of phase 3, and the
+            // stage 2 output for the first one
+            case 3:
+                acc1 = stage1.fold<0, 4, 0>(0);
+                acc2 = stage2.fold<3, 6, 0>(acc2);
+                break;
+            case 4:
+                acc1 = stage1.fold<4, 8, 1>(acc1);
+                out = stage2.fold<6, 8, 0>(acc2);
+                break;
+            case 5:
+                stage2.push(stage1.fold<8, 11, 2>(acc1));
+                break;
+        }
+
+        phase = (phase + 1) % resample_factor;
+        return phase == 0;
+    }
+
+    float output() const
+    {
+        return out;
+    }
+
+private:
+    // 48000 Hz sample rate
+    // 0-1800 Hz pass band (3 dB ripple)
+    // 8000-24000 Hz stop band (-80 dB)
+    PolyphaseDecimator<3, 21> stage1{{
+        0.000066177472224418f,
+        0.0009613901552378511f,
+        0.003835090815380887f,
+        0.010496532623165526f,
+        0.02272703591356282f,
+        0.041464390530886956f,
+        0.06591039391505207f,
+        0.09309984953947406f,
+        0.11829177835273737f,
+        0.13620590247679107f,
+        0.14270010010002276f,
+    }};
+
+    // Half-band filter
+    // 16000 Hz sample rate
+    // 0-1800 Hz pass band
+    PolyphaseDecimator<2, 15> stage2{{
+        -0.00299995f,
+        0.0f,
+        0.01858487f,
+        0.0f,
+        -0.06984829f,
+        0.0f,
+        0.30421664f,
+        0.5f,
+    }};
+
+
+    std::size_t phase = 0;
+    float acc1 = 0;
+    float acc2 = 0;
+    float out = 0;
+};
+
+
+//=============================================================================
+// 8000 Hz -> 48000 Hz, as interpolate by 2 then interpolate by 3
+class Interpolator
+{
+public:
+    std::array<float, resample_factor> operator()(float s)
+    {
+        std::array<float, resample_factor> output;
+
+        stage1.push(s);
+
+        stage2.push(stage1.output<0>());
+        output[0] = stage2.output<0>();
+        output[1] = stage2.output<1>();
+        output[2] = stage2.output<2>();
+
+        stage2.push(stage1.output<1>());
+        output[3] = stage2.output<0>();
+        output[4] = stage2.output<1>();
+        output[5] = stage2.output<2>();
+
+        return output;
+    }
+
+    // Block form: interpolates `count` low-rate samples into
+    // count * resample_factor full-rate samples in `out`
+    void process(const float* in, std::size_t count, float* out)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto output = (*this)(in[i]);
+            std::copy(output.begin(), output.end(), out + i * resample_factor);
+        }
+    }
+
+    // Incremental form of operator(): push() one low-rate sample, then call
+    // next() resample_factor times for the full-rate outputs, one per sample.
+    // Gives the same outputs as operator() with the filter work spread over
+    // the period. Don't mix the two forms on one Interpolator.
+    void push(float s)
+    {
+        stage1.push(s);
+        phase = 0;
+    }
+
+    float next()
+    {
+        float output = 0;
+
+        switch (phase)
+        {
+            case 0:
+                stage2.push(stage1.output<0>());
+                output = stage2.output<0>();
+                break;
+            case 1:
+                pending = stage1.output<1>(); // stage 1 doesn't change until push()
+                output = stage2.output<1>();
+                break;
+            case 2: output = stage2.output<2>(); break;
+            case 3:
+                stage2.push(pending);
+                output = stage2.output<0>();
+                break;
+            case 4: output = stage2.output<1>(); break;
+            case 5: output = stage2.output<2>(); break;
+        }
+
+        phase = (phase + 1) % resample_factor;
+        return output;
+    }
+
+private:
+    // 16000 Hz sample rate
+    // 0-3600 Hz pass band (3 dB ripple)
+    // 4400-8000 Hz stop band (-80 dB)
+    // Gain=2 in passband
+    PolyphaseInterpolator<2, 49> stage1{{
+        -0.0028536199247471473f,
+        -0.015961858776449508f,
+        -0.040326725115203695f,
+        -0.056128740058266235f,
+        -0.036134596458820015f,
+        0.011026026040094625f,
+        0.033522051189265496f,
+        0.003198795994721635f,
+        -0.031442224275585025f,
+        -0.01108582057161854f,
+        0.03258337681750486f,
+        0.01951384497860086f,
+        -0.03538414864961937f,
+        -0.030860282826182514f,
+        0.038811868988079715f,
+        0.04707993944078406f,
+        -0.042204493894155204f,
+        -0.07155908583004919f,
+        0.045128824129776035f,
+        0.1129220770668398f,
+        -0.04736995557907843f,
+        -0.2033122562119347f,
+        0.048831901671617876f,
+        0.6336728217960803f,
+        0.9507771467941135f,
+    }};
+
+    // 48000 Hz sample rate
+    // 0-3600 Hz pass band (3 dB ripple)
+    // 8000-24000 Hz stop band (-80 dB)
+    // Gain=3 in passband
+    PolyphaseInterpolator<3, 33> stage2{{
+        0.00036440608905813593f,
+        0.001112114188613258f,
+        0.001762424830497545f,
+        0.0005821260464558225f,
+        -0.005449383064836152f,
+        -0.019627176246818184f,
+        -0.043244023722481956f,
+        -0.07276547446584428f,
+        -0.09801301258361905f,
+        -0.10310036386076359f,
+        -0.0709695783332148f,
+        0.009420000864297772f,
+        0.13604229993913602f,
+        0.2904591843823435f,
+        0.4407091552750118f,
+        0.5503466630244301f,
+        0.590541634315722f,
+    }};
+
+    std::size_t phase = 0;
+    float pending = 0;
+};
+
+
+//=============================================================================
+// Runs Decimator2 -> low-rate Stage -> Interpolator one full-rate sample at
+// a time, with the work spread evenly over each low-rate period.
+//
+// Calling the three in a burst on every resample_factor'th sample puts almost
+// all of the work on one sample in six, and that worst case sets how small
+// the audio block can be. Here every full-rate sample decimates one input,
+// runs one slice of the Stage's work on the previous low-rate sample and
+// produces one interpolated output. The cost is resample_factor - 1 samples
+// of latency over the burst, whose outputs otherwise match.
+//
+// Stage needs:
+//   void begin(float sample)    start on a new low-rate sample
+//   void step(std::size_t i)    do slice i (0 to resample_factor-1) of it
+//   float end()                 the low-rate output, after the last slice
+//
+// process() is a block form for when the whole callback block is available
+// up front. It decimates the block, runs the Stage once over all of the
+// low-rate samples and then interpolates, with the same output as calling
+// operator() per sample. For it, Stage needs instead:
+//   void process(const float* in, float* out, std::size_t count)
+// where count is at most max_low_rate_block.
+//
+// Use one form or the other on a given scheduler, not both.
+//
+// The Stage is held by value and everything else is fixed-size, so a
+// scheduler whose Stage owns its generator is the whole engine in one
+// contiguous object, with no heap, that can be placed in any RAM region.
+template <typename Stage>
+class MultirateScheduler
+{
+public:
+    // Builds the Stage in place (a generator can be several KB, too big to
+    // pass through the stack by value)
+    MultirateScheduler() = default;
+
+    explicit MultirateScheduler(const Stage& stage)
+      : _stage(stage)
+    {
+    }
+
+    Stage& stage()
+    {
+        return _stage;
+    }
+
+    // Starts over from silence: clears the resampling filters and calls
+    // Stage::reset(), which the Stage must provide to use this
+    void reset()
+    {
+        _stage.reset();
+        _decimate = Decimator2();
+        _interpolate = Interpolator();
+        _phase = 0;
+        _primed = false;
+        _pending = 0;
+    }
+
+    float operator()(float s)
+    {
+        if (_primed)
+        {
+            _stage.step(_phase);
+        }
+        if (_phase == resample_factor - 1)
+        {
+            _interpolate.push(_primed ? _stage.end() : 0.0f);
+        }
+
+        const float output = _interpolate.next();
+
+        if (_decimate.push(s))
+        {
+            _stage.begin(_decimate.output());
+            _primed = true;
+        }
+
+        _phase = (_phase + 1) % resample_factor;
+        return output;
+    }
+
+    // `out` may be the same buffer as `in`
+    void process(const float* in, float* out, std::size_t count)
+    {
+        while (count > 0)
+        {
+            const std::size_t n = std::min(count, max_chunk);
+
+            const std::size_t low = _decimate.process(in, n, _low.data());
+            _stage.process(_low.data(), _wet.data(), low);
+
+            // Each low-rate result goes into the interpolator resample_factor
+            // samples after its input came out of the decimator, as in
+            // operator()
+            std::size_t next = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const bool last = (_phase == resample_factor - 1);
+                if (last)
+                {
+                    _interpolate.push(_pending);
+                }
+                out[i] = _interpolate.next();
+                if (last)
+                {
+                    _pending = _wet[next++];
+                }
+                _phase = (_phase + 1) % resample_factor;
+            }
+
+            in += n;
+            out += n;
+            count -= n;
+        }
+    }
+
+private:
+    static constexpr std::size_t max_chunk = max_low_rate_block * resample_factor;
+
+    Stage _stage;
+    Decimator2 _decimate;
+    Interpolator _interpolate;
+    std::size_t _phase = 0;
+    bool _primed = false;
+
+    // Block form
+    std::array<float, max_low_rate_block> _low{};
+    std::array<float, max_low_rate_block> _wet{};
+    float _pending = 0;
+};
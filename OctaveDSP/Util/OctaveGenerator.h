@@ -0,0 +1,170 @@
+#pragma once
+
+#include "BandShifterBank.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <gcem.hpp>
+
+//=============================================================================
+// Splits the signal into bands and octave-shifts each one.
+//
+// MaxBands fixes the storage at compile time. The number of bands actually
+// processed and the range they cover can be changed at run time: fewer
+// bands, or a narrower range for bass, trade octave tracking quality for
+// CPU. The default is the original layout, 80 bands from 60 Hz to ~1.7 kHz.
+template <std::size_t MaxBands = 80>
+class OctaveGenerator
+{
+public:
+    static constexpr std::size_t max_bands = MaxBands;
+    static constexpr float default_low_hz = 60;
+    static constexpr float default_high_hz = 480 * gcem::pow(2.0f, (0.027f * 79)) - 420;
+
+    OctaveGenerator(float sample_rate,
+                    std::size_t bands = MaxBands,
+                    float low_hz = default_low_hz,
+                    float high_hz = default_high_hz)
+        : _sample_rate(sample_rate)
+    {
+        setBands(bands, low_hz, high_hz);
+    }
+
+    // Lays out `bands` bands (at most MaxBands) between low_hz and high_hz
+    // and resets their state. This computes new filter coefficients in
+    // double precision, so call it on a preset change, not per sample.
+    void setBands(std::size_t bands, float low_hz, float high_hz)
+    {
+        _num_bands = std::clamp<std::size_t>(bands, 2, MaxBands);
+        _low_hz = low_hz;
+        _high_hz = std::max(high_hz, low_hz + 1);
+
+        for (std::size_t i = 0; i < _num_bands; ++i)
+        {
+            const auto center = centerFreq(i, _num_bands, _low_hz, _high_hz);
+            const auto bw = bandwidth(i, _num_bands, _low_hz, _high_hz);
+            _shifters.setBand(i, center, _sample_rate, bw);
+        }
+        _shifters.setActiveBands(_num_bands);
+    }
+
+    // Lets bands whose level stays below `level` (linear amplitude, 0 =
+    // never) skip the phase scaling. See BandShifterBank.
+    void setSleepThreshold(float level)
+    {
+        _shifters.setSleepThreshold(level);
+    }
+
+    // Picks the phase scaling kernel. ShifterQuality::fast needs half the
+    // inverse square roots; see BandShifterBank.
+    void setQuality(ShifterQuality quality)
+    {
+        _shifters.setQuality(quality);
+    }
+
+    // Clears the band state, keeping the layout and settings
+    void reset()
+    {
+        _shifters.reset();
+    }
+
+    void update(float sample)
+    {
+        _shifters.update(sample);
+    }
+
+    // Block form of update(): runs `count` samples from `in` and writes the
+    // outputs for each to up1, down1 and down2 (which must not overlap `in`).
+    // Faster than calling update() per sample; see BandShifterBank::process.
+    void process(const float* in, std::size_t count,
+                 float* up1, float* down1, float* down2)
+    {
+        _shifters.process(in, count, up1, down1, down2);
+    }
+
+    // Incremental form of update(), for spreading the band work over several
+    // calls (see MultirateScheduler): begin(sample), then step(i, steps) for
+    // i = 0 to steps-1, then end(). Gives the same outputs as update().
+    void begin(float sample)
+    {
+        _shifters.begin(sample);
+    }
+
+    void step(std::size_t i, std::size_t steps)
+    {
+        const std::size_t n = _num_bands;
+        _shifters.updateBands(n * i / steps, n * (i + 1) / steps);
+    }
+
+    void end()
+    {
+        _shifters.end();
+    }
+
+    float up1() const
+    {
+        return _shifters.up1();
+    }
+
+    float down1() const
+    {
+        return _shifters.down1();
+    }
+
+    float down2() const
+    {
+        return _shifters.down2();
+    }
+
+    std::size_t numBands() const
+    {
+        return _num_bands;
+    }
+
+    std::size_t awakeBands() const
+    {
+        return _shifters.awakeBands();
+    }
+
+    float lowHz() const
+    {
+        return _low_hz;
+    }
+
+    float highHz() const
+    {
+        return _high_hz;
+    }
+
+    // Center of band n when `bands` bands span [low_hz, high_hz]. Keeps the
+    // spacing of the original layout (480 * 2^(0.027 n) - 420): close to
+    // linear at the bottom of the range, close to logarithmic at the top.
+    static constexpr float centerFreq(const int n, const std::size_t bands,
+                                      const float low_hz, const float high_hz)
+    {
+        const float rate = gcem::log2((high_hz - low_hz) / knee_hz + 1) / (bands - 1);
+        return knee_hz * gcem::pow(2.0f, (rate * n)) - (knee_hz - low_hz);
+    }
+
+    static constexpr float bandwidth(const int n, const std::size_t bands,
+                                     const float low_hz, const float high_hz)
+    {
+        const float f0 = centerFreq(n-1, bands, low_hz, high_hz);
+        const float f1 = centerFreq(n, bands, low_hz, high_hz);
+        const float f2 = centerFreq(n+1, bands, low_hz, high_hz);
+        const float a = (f2 - f1);
+        const float b = (f1 - f0);
+        return 2.0f * (a*b) / (a+b);
+    }
+
+private:
+    static constexpr float knee_hz = 480;
+
+    float _sample_rate;
+    std::size_t _num_bands = MaxBands;
+    float _low_hz = default_low_hz;
+    float _high_hz = default_high_hz;
+
+    BandShifterBank<MaxBands> _shifters;
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Multirate.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+//=============================================================================
+// Interpolates by 2 with a half-band FIR of Taps taps (Taps = 4k + 3).
+//
+// Every other tap of a half-band filter is zero, so of the two polyphase
+// branches, one is the center tap alone (a plain delay) and the other is
+// symmetric and folded. That is (Taps + 1) / 4 multiplies per input sample.
+// The filter is given as the nonzero taps before the center, h[0], h[2],
+// ..., h[(Taps - 3) / 2]; the center tap is 0.5.
+template <std::size_t Taps>
+class HalfbandInterpolator
+{
+public:
+    static_assert(Taps % 4 == 3);
+
+    static constexpr std::size_t taps = Taps;
+    static constexpr std::size_t terms = (Taps + 1) / 4;
+
+    explicit constexpr HalfbandInterpolator(const std::array<float, terms>& half)
+    {
+        for (std::size_t i = 0; i < terms; ++i)
+        {
+            h[i] = 2 * half[i];
+        }
+    }
+
+    // Writes 2 * count samples to `out`. `out` may overlap `in` as long as
+    // it starts at least `count` samples before it.
+    void process(const float* in, std::size_t count, float* out)
+    {
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            history.push(in[n]);
+
+            float sum = 0;
+            for (std::size_t i = 0; i < terms; ++i)
+            {
+                sum += h[i] * (history(i) + history(2 * terms - 1 - i));
+            }
+            out[2 * n] = sum;
+            out[2 * n + 1] = history(terms - 1);
+        }
+    }
+
+    void reset()
+    {
+        history = {};
+    }
+
+private:
+    std::array<float, terms> h{};
+    HistoryBuffer<2 * terms> history;
+};
+
+
+//=============================================================================
+// Decimates by 2 with a half-band FIR of Taps taps (Taps = 4k + 3).
+//
+// Only every other output is computed, and of the taps that remain, one is
+// the center and the rest are symmetric and folded: (Taps + 1) / 4
+// multiplies per output sample, plus one for the center. The filter is
+// given as for HalfbandInterpolator.
+template <std::size_t Taps>
+class HalfbandDecimator
+{
+public:
+    static_assert(Taps % 4 == 3);
+
+    static constexpr std::size_t taps = Taps;
+    static constexpr std::size_t terms = (Taps + 1) / 4;
+
+    explicit constexpr HalfbandDecimator(const std::array<float, terms>& half)
+      : h(half)
+    {
+    }
+
+    // Reads 2 * count samples from `in` and writes count samples to `out`,
+    // which may be `in` itself.
+    void process(const float* in, std::size_t count, float* out)
+    {
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            history.push(in[2 * n]);
+            history.push(in[2 * n + 1]);
+
+            float sum = 0.5f * history((Taps - 1) / 2);
+            for (std::size_t i = 0; i < terms; ++i)
+            {
+                sum += h[i] * (history(2 * i) + history(Taps - 1 - 2 * i));
+            }
+            out[n] = sum;
+        }
+    }
+
+    void reset()
+    {
+        history = {};
+    }
+
+private:
+    std::array<float, terms> h;
+    HistoryBuffer<Taps> history;
+};
+
+
+//=============================================================================
+// Runs a nonlinearity at 2, 4 or 8 times the sample rate, as a cascade of
+// half-band stages, with no allocation. The caller provides the buffer for
+// the oversampled signal:
+//
+//    float buffer[block_size * Oversampler::max_ratio];
+//    oversampler.upsample(in, count, buffer);
+//    for (std::size_t i = 0; i < count * oversampler.ratio(); ++i)
+//        buffer[i] = shape(buffer[i]);
+//    oversampler.downsample(buffer, count, out);
+//
+// or process(in, out, count, buffer, shape) for the same thing. Any count
+// works, including 1 for per-sample use.
+//
+// The filters are designed for a 48 kHz base rate: flat to 20 kHz, and at
+// least 70 dB down from 28 kHz to the Nyquist frequency of each stage, so
+// images and aliases that would land below 20 kHz are removed. Each of
+// upsample() and downsample() delays the signal by ~14 base-rate samples
+// at 2x, ~16 at 4x and ~17 at 8x.
+class Oversampler
+{
+public:
+    static constexpr std::size_t max_ratio = 8;
+
+    explicit Oversampler(std::size_t ratio = 4)
+    {
+        setRatio(ratio);
+    }
+
+    // Ratio 1, 2, 4 or 8 (others round down). Clears the filter state.
+    void setRatio(std::size_t ratio)
+    {
+        _stages = (ratio >= 8) ? 3 : (ratio >= 4) ? 2 : (ratio >= 2) ? 1 : 0;
+        reset();
+    }
+
+    std::size_t ratio() const
+    {
+        return std::size_t(1) << _stages;
+    }
+
+    void reset()
+    {
+        up1.reset();
+        up2.reset();
+        up3.reset();
+        down1.reset();
+        down2.reset();
+        down3.reset();
+    }
+
+    // Writes count * ratio() samples to `buffer`, which must not overlap `in`.
+    // The stages run in place from the end of the buffer forwards.
+    void upsample(const float* in, std::size_t count, float* buffer)
+    {
+        switch (_stages)
+        {
+        case 0:
+            std::copy(in, in + count, buffer);
+            break;
+        case 1:
+            up1.process(in, count, buffer);
+            break;
+        case 2:
+            up1.process(in, count, buffer + 2 * count);
+            up2.process(buffer + 2 * count, 2 * count, buffer);
+            break;
+        default:
+            up1.process(in, count, buffer + 6 * count);
+            up2.process(buffer + 6 * count, 2 * count, buffer + 4 * count);
+            up3.process(buffer + 4 * count, 4 * count, buffer);
+            break;
+        }
+    }
+
+    // Reads count * ratio() samples from `buffer` and writes count samples
+    // to `out`. The stages run in place, so the buffer is overwritten.
+    void downsample(float* buffer, std::size_t count, float* out)
+    {
+        switch (_stages)
+        {
+        case 0:
+            std::copy(buffer, buffer + count, out);
+            break;
+        case 1:
+            down1.process(buffer, count, out);
+            break;
+        case 2:
+            down2.process(buffer, 2 * count, buffer);
+            down1.process(buffer, count, out);
+            break;
+        default:
+            down3.process(buffer, 4 * count, buffer);
+            down2.process(buffer, 2 * count, buffer);
+            down1.process(buffer, count, out);
+            break;
+        }
+    }
+
+    // upsample(), shape every oversampled sample, downsample(). `out` may
+    // be `in`.
+    template <typename Shaper>
+    void process(const float* in, float* out, std::size_t count,
+                 float* buffer, Shaper&& shape)
+    {
+        upsample(in, count, buffer);
+        for (std::size_t i = 0, n = count * ratio(); i < n; ++i)
+        {
+            buffer[i] = shape(buffer[i]);
+        }
+        downsample(buffer, count, out);
+    }
+
+private:
+    // Half-band filter, 55 taps
+    // 96000 Hz sample rate
+    // 0-20000 Hz pass band (0.003 dB ripple)
+    // 28000-48000 Hz stop band (-71 dB)
+    static constexpr std::array<float, 14> stage1 = {
+        -6.374253246e-05f, 2.606995491e-04f, -6.644775745e-04f,
+        1.386326986e-03f, -2.567566597e-03f, 4.385128692e-03f,
+        -7.064643949e-03f, 1.091191039e-02f, -1.638837999e-02f,
+        2.430002641e-02f, -3.632471685e-02f, 5.681984054e-02f,
+        -1.018697963e-01f, 3.168793913e-01f,
+    };
+
+    // Half-band filter, 23 taps
+    // 192000 Hz sample rate
+    // 0-28000 Hz pass band (0.002 dB ripple)
+    // 68000-96000 Hz stop band (-72 dB)
+    static constexpr std::array<float, 6> stage2 = {
+        -1.425740861e-04f, 2.222776961e-03f, -1.004425251e-02f,
+        3.078442481e-02f, -8.238489740e-02f, 3.095645222e-01f,
+    };
+
+    // Half-band filter, 15 taps
+    // 384000 Hz sample rate
+    // 0-28000 Hz pass band (0.001 dB ripple)
+    // 164000-192000 Hz stop band (-77 dB)
+    static constexpr std::array<float, 4> stage3 = {
+        -1.343443980e-04f, 7.496562637e-03f, -5.295622362e-02f,
+        2.955940054e-01f,
+    };
+
+    HalfbandInterpolator<55> up1{stage1};
+    HalfbandInterpolator<23> up2{stage2};
+    HalfbandInterpolator<15> up3{stage3};
+    HalfbandDecimator<15> down3{stage3};
+    HalfbandDecimator<23> down2{stage2};
+    HalfbandDecimator<55> down1{stage1};
+    std::size_t _stages = 2;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+//=============================================================================
+// OctaveDSP version (see OctaveDSP/README.md for the history). The minor
+// version goes up for additions, the major version for changes that break
+// a port's build or change its sound; ports check the major version they
+// were written against.
+#define OCTAVE_DSP_VERSION_MAJOR 1
+#define OCTAVE_DSP_VERSION_MINOR 1
+#define OCTAVE_DSP_VERSION_PATCH 0
@@ -0,0 +1,145 @@
+// BandShifterBank against the array of BandShifters it replaces, per band
+// and sample, with the per-sample and block forms and each kernel, and with
+// sleep gating on a DI corpus
+//
+// For numbers closer to the Cortex-M7, which has no float SIMD, build
+// without vectorization:
+//   make bench BENCHFLAGS="-Ofast -fno-strict-aliasing -fno-tree-vectorize"
+
+#include "Bench.h"
+#include "Test.h"
+
+#include "Util/BandShifter.h"
+#include "Util/OctaveGenerator.h"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 8000;
+    constexpr std::size_t bands = 80;
+    constexpr std::size_t block = 8; // one 48-sample audio block at 8 kHz
+    constexpr int runs = 5;
+
+    using Generator = OctaveGenerator<bands>;
+
+    std::vector<BandShifter> shifters()
+    {
+        std::vector<BandShifter> s;
+        for (std::size_t n = 0; n < bands; ++n)
+        {
+            const int i = static_cast<int>(n);
+            s.emplace_back(
+                Generator::centerFreq(i, bands, Generator::default_low_hz, Generator::default_high_hz),
+                sample_rate,
+                Generator::bandwidth(i, bands, Generator::default_low_hz, Generator::default_high_hz));
+        }
+        return s;
+    }
+
+    void report(const char* name, double ticks, std::size_t samples, double baseline)
+    {
+        const double per = ticks / double(samples * bands);
+        std::printf("  %-40s %6.2f %s per band-sample", name, per, bench::unit());
+        if (baseline > 0)
+        {
+            std::printf("  (%.2fx)", baseline / per);
+        }
+        std::printf("\n");
+    }
+}
+
+int main()
+{
+    const auto x = test::diCorpus(sample_rate, 20);
+    std::vector<float> up1(x.size()), down1(x.size()), down2(x.size());
+
+    auto aos = shifters();
+    const double array = bench::best(runs, [&]
+    {
+        for (const float s : x)
+        {
+            float sum = 0;
+            for (auto& shifter : aos)
+            {
+                shifter.update(s);
+                sum += shifter.up1() + shifter.down1() + shifter.down2();
+            }
+            bench::sink = sum;
+        }
+    });
+    const double baseline = array / double(x.size() * bands);
+
+    std::printf("%zu bands, %zu samples, no gating\n", bands, x.size());
+    report("std::vector<BandShifter>", array, x.size(), 0);
+
+    for (const auto quality : {ShifterQuality::reference, ShifterQuality::fast, ShifterQuality::high})
+    {
+        const char* name = (quality == ShifterQuality::reference) ? "reference"
+                         : (quality == ShifterQuality::fast) ? "fast" : "high";
+        auto generator = std::make_unique<Generator>(sample_rate);
+        generator->setQuality(quality);
+
+        const double per_sample = bench::best(runs, [&]
+        {
+            for (const float s : x)
+            {
+                generator->update(s);
+                bench::sink = generator->up1() + generator->down1() + generator->down2();
+            }
+        });
+
+        const double blocks = bench::best(runs, [&]
+        {
+            for (std::size_t i = 0; i + block <= x.size(); i += block)
+            {
+                generator->process(&x[i], block, &up1[i], &down1[i], &down2[i]);
+            }
+            bench::sink = up1[0];
+        });
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "BandShifterBank %s, update()", name);
+        report(label, per_sample, x.size(), baseline);
+        std::snprintf(label, sizeof(label), "BandShifterBank %s, process(%zu)", name, block);
+        report(label, blocks, x.size(), baseline);
+    }
+
+    // Sleep gating, with the ports' default kernel and threshold
+    std::printf("sleep gating, fast kernel, update()\n");
+    double ungated = 0;
+    for (const float sleep_level : {0.0f, 0.0001f})
+    {
+        auto generator = std::make_unique<Generator>(sample_rate);
+        generator->setQuality(ShifterQuality::fast);
+        generator->setSleepThreshold(sleep_level);
+
+        double awake = 0;
+        const double ticks = bench::best(runs, [&]
+        {
+            generator->reset();
+            awake = 0;
+            for (const float s : x)
+            {
+                generator->update(s);
+                awake += double(generator->awakeBands());
+            }
+        });
+        if (sleep_level == 0)
+        {
+            ungated = ticks;
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "threshold %g (%.1f bands awake)",
+                      sleep_level, awake / double(x.size()));
+        report(label, ticks, x.size(), 0);
+        if (sleep_level > 0)
+        {
+            std::printf("  %.2fx the ungated time\n", ticks / ungated);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,306 @@
+// BandShifterBank against BandShifter, and its phase scaling kernels
+// against exact math
+//
+// The exact reference is BandShifter with the fast square roots replaced by
+// exact ones, computed in double. The filter and the sign tracking are the
+// same, so the differences measured are those of the kernels'
+// approximations.
+
+#include "Test.h"
+
+#include "Util/BandShifter.h"
+#include "Util/OctaveGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 8000;
+
+    class ExactShifter
+    {
+    public:
+        ExactShifter(float center, float bw)
+          : _k(center, sample_rate, bw)
+        {
+        }
+
+        void update(float sample)
+        {
+            const auto prev_y = _y;
+            _y = _s2 + _k.d0*sample;
+            _s2 = _s1 + _k.d1*sample - _k.c1*_y;
+            _s1 = _k.d2*sample - _k.c2*_y;
+
+            if ((_y.real() < 0) &&
+                (std::signbit(_y.imag()) != std::signbit(prev_y.imag())))
+            {
+                _down1_sign = -_down1_sign;
+            }
+
+            const std::complex<double> y(_y);
+            const double r = std::abs(y);
+            up1 = (r > 0) ? (y * y).real() / r : 0;
+
+            const auto prev_down1 = _down1;
+            _down1 = _down1_sign * halfAngle(y);
+            down1 = _down1.real();
+
+            if ((_down1.real() < 0) &&
+                (std::signbit(_down1.imag()) != std::signbit(prev_down1.imag())))
+            {
+                _down2_sign = -_down2_sign;
+            }
+            down2 = _down2_sign * halfAngle(_down1).real();
+        }
+
+        double up1 = 0;
+        double down1 = 0;
+        double down2 = 0;
+
+    private:
+        // z rotated by half its angle (towards the positive imaginary axis
+        // for negative imaginary parts, as BandShifter does), keeping |z|
+        static std::complex<double> halfAngle(std::complex<double> z)
+        {
+            const double r = std::abs(z);
+            if (r == 0)
+            {
+                return 0;
+            }
+            const double x = 0.5 * z.real() / r;
+            const double c = std::sqrt(std::max(0.5 + x, 0.0));
+            const double d = ((z.imag() < 0) ? -1.0 : 1.0) * std::sqrt(std::max(0.5 - x, 0.0));
+            return {z.real()*c + z.imag()*d, z.imag()*c - z.real()*d};
+        }
+
+        BandShifterCoefficients _k;
+        std::complex<float> _s1;
+        std::complex<float> _s2;
+        std::complex<float> _y;
+        std::complex<double> _down1;
+        double _down1_sign = 1;
+        double _down2_sign = 1;
+    };
+
+    // Decaying harmonic notes over the guitar range, at the low rate
+    std::vector<float> notes()
+    {
+        std::vector<float> x;
+        for (const float f : {82.4f, 110.0f, 146.8f, 196.0f, 246.9f, 329.6f, 220.0f, 164.8f})
+        {
+            for (int k = 0; k < 8000; ++k)
+            {
+                const float envelope = 0.5f * std::exp(-k / 3000.0f);
+                float v = 0;
+                for (int h = 1; h <= 5; ++h)
+                {
+                    v += envelope / h * std::sin(2 * std::numbers::pi_v<float> * f * h * k / sample_rate);
+                }
+                x.push_back(v);
+            }
+        }
+        return x;
+    }
+
+    struct Outputs
+    {
+        std::vector<float> up1, down1, down2;
+
+        bool operator==(const Outputs&) const = default;
+    };
+
+    using Generator = OctaveGenerator<>;
+
+    // The generator's default band layout, for the per-band references
+    template <typename Shifter, typename... Args>
+    std::vector<Shifter> layout(Args... args)
+    {
+        std::vector<Shifter> bands;
+        for (std::size_t n = 0; n < Generator::max_bands; ++n)
+        {
+            const int i = static_cast<int>(n);
+            const float center = Generator::centerFreq(
+                i, Generator::max_bands, Generator::default_low_hz, Generator::default_high_hz);
+            const float bw = Generator::bandwidth(
+                i, Generator::max_bands, Generator::default_low_hz, Generator::default_high_hz);
+            bands.emplace_back(center, args..., bw);
+        }
+        return bands;
+    }
+
+    // What BandShifterBank replaced: one BandShifter per band
+    Outputs shifters(const std::vector<float>& x)
+    {
+        auto bands = layout<BandShifter>(sample_rate);
+
+        Outputs out;
+        for (const float s : x)
+        {
+            float up1 = 0, down1 = 0, down2 = 0;
+            for (auto& band : bands)
+            {
+                band.update(s);
+                up1 += band.up1();
+                down1 += band.down1();
+                down2 += band.down2();
+            }
+            out.up1.push_back(up1);
+            out.down1.push_back(down1);
+            out.down2.push_back(down2);
+        }
+        return out;
+    }
+
+    Outputs exact(const std::vector<float>& x)
+    {
+        auto bands = layout<ExactShifter>();
+
+        Outputs out;
+        for (const float s : x)
+        {
+            double up1 = 0, down1 = 0, down2 = 0;
+            for (auto& band : bands)
+            {
+                band.update(s);
+                up1 += band.up1;
+                down1 += band.down1;
+                down2 += band.down2;
+            }
+            out.up1.push_back(float(up1));
+            out.down1.push_back(float(down1));
+            out.down2.push_back(float(down2));
+        }
+        return out;
+    }
+
+    // The generator per sample through update(), or with `steps` > 0,
+    // through begin(), step() and end()
+    Outputs run(const std::vector<float>& x, ShifterQuality quality,
+                float sleep_threshold = 0, std::size_t steps = 0)
+    {
+        Generator generator(sample_rate);
+        generator.setQuality(quality);
+        generator.setSleepThreshold(sleep_threshold);
+
+        Outputs out;
+        for (const float s : x)
+        {
+            if (steps == 0)
+            {
+                generator.update(s);
+            }
+            else
+            {
+                generator.begin(s);
+                for (std::size_t i = 0; i < steps; ++i)
+                {
+                    generator.step(i, steps);
+                }
+                generator.end();
+            }
+            out.up1.push_back(generator.up1());
+            out.down1.push_back(generator.down1());
+            out.down2.push_back(generator.down2());
+        }
+        return out;
+    }
+
+    // The generator's block form, in blocks of `block` samples
+    Outputs runBlocks(const std::vector<float>& x, ShifterQuality quality,
+                      float sleep_threshold, std::size_t block)
+    {
+        Generator generator(sample_rate);
+        generator.setQuality(quality);
+        generator.setSleepThreshold(sleep_threshold);
+
+        Outputs out;
+        out.up1.resize(x.size());
+        out.down1.resize(x.size());
+        out.down2.resize(x.size());
+        for (std::size_t i = 0; i < x.size(); i += block)
+        {
+            generator.process(&x[i], std::min(block, x.size() - i),
+                              &out.up1[i], &out.down1[i], &out.down2[i]);
+        }
+        return out;
+    }
+
+    const char* name(ShifterQuality quality)
+    {
+        switch (quality)
+        {
+        case ShifterQuality::fast: return "fast";
+        case ShifterQuality::high: return "high";
+        default: return "reference";
+        }
+    }
+
+    // Minimum SNR against exact math, in dB, for up1, down1 and down2
+    struct Limits
+    {
+        const char* name;
+        ShifterQuality quality;
+        double up1, down1, down2;
+    };
+}
+
+int main()
+{
+    const auto x = notes();
+
+    // The reference kernel is BandShifter's math, so without -ffast-math
+    // the sums come out the same
+    {
+        const auto want = shifters(x);
+        const auto got = run(x, ShifterQuality::reference);
+        test::check(got == want, "reference kernel == std::vector<BandShifter>");
+    }
+
+    // The incremental and block forms give the same outputs as update()
+    for (const auto quality : {ShifterQuality::reference, ShifterQuality::fast, ShifterQuality::high})
+    {
+        for (const float sleep_threshold : {0.0f, 0.0001f})
+        {
+            const auto want = run(x, quality, sleep_threshold);
+            const char* gated = (sleep_threshold > 0) ? ", gated" : "";
+            test::check(run(x, quality, sleep_threshold, 6) == want,
+                        "%s%s: begin()/step()/end() == update()", name(quality), gated);
+            test::check(runBlocks(x, quality, sleep_threshold, 8) == want &&
+                        runBlocks(x, quality, sleep_threshold, 61) == want,
+                        "%s%s: process() == update()", name(quality), gated);
+        }
+    }
+
+    const auto want = exact(x);
+
+    // A few dB under what each kernel measures
+    const Limits limits[] = {
+        {"reference", ShifterQuality::reference, 55, 45, 8},
+        {"fast", ShifterQuality::fast, 55, 50, 45},
+        {"high", ShifterQuality::high, 100, 100, 55},
+    };
+
+    double down2_snr[3] = {};
+    for (std::size_t i = 0; i < std::size(limits); ++i)
+    {
+        const auto& limit = limits[i];
+        const auto got = run(x, limit.quality);
+        const double up1 = test::snrDb(want.up1, got.up1);
+        const double down1 = test::snrDb(want.down1, got.down1);
+        const double down2 = test::snrDb(want.down2, got.down2);
+        down2_snr[i] = down2;
+
+        test::check(up1 >= limit.up1, "%s up1 vs exact: %.1f dB SNR (>= %.0f)", limit.name, up1, limit.up1);
+        test::check(down1 >= limit.down1, "%s down1 vs exact: %.1f dB SNR (>= %.0f)", limit.name, down1, limit.down1);
+        test::check(down2 >= limit.down2, "%s down2 vs exact: %.1f dB SNR (>= %.0f)", limit.name, down2, limit.down2);
+    }
+
+    test::check(down2_snr[1] > down2_snr[0] && down2_snr[2] > down2_snr[1],
+                "down2 improves from reference to fast to high");
+
+    return test::result();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//=============================================================================
+// Timing helpers for the host benchmarks. Host timings only compare
+// implementations with each other; check the real cost on the pedal.
+namespace bench
+{
+    // CPU cycles where the host has a cycle counter, nanoseconds otherwise
+    inline std::uint64_t ticks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    inline const char* unit()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return "cycles";
+#else
+        return "ns";
+#endif
+    }
+
+    // Fastest of `runs` runs of fn(), in ticks, to keep other load on the
+    // host out of the numbers
+    template <typename Fn>
+    double best(int runs, Fn&& fn)
+    {
+        std::uint64_t fastest = std::numeric_limits<std::uint64_t>::max();
+        for (int i = 0; i < runs; ++i)
+        {
+            const std::uint64_t start = ticks();
+            fn();
+            fastest = std::min(fastest, ticks() - start);
+        }
+        return double(fastest);
+    }
+
+    // Keeps the compiler from dropping a result
+    inline volatile float sink = 0;
+}
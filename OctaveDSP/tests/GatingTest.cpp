@@ -0,0 +1,112 @@
+// Sleep gating in BandShifterBank, on a plucked-string DI corpus: how many
+// bands stay awake, and how far the gated output is from the ungated one
+
+#include "Test.h"
+
+#include "Util/OctaveGenerator.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 8000;
+    constexpr float sleep_level = 0.0001f; // the ports' OCTAVE_SLEEP_LEVEL
+
+    using Generator = OctaveGenerator<>;
+
+    struct Run
+    {
+        std::vector<float> up1, down1;
+        double awake = 0; // average awake bands per sample
+    };
+
+    Run run(const std::vector<float>& x, float sleep_threshold)
+    {
+        auto generator = std::make_unique<Generator>(sample_rate);
+        generator->setQuality(ShifterQuality::fast);
+        generator->setSleepThreshold(sleep_threshold);
+
+        Run out;
+        for (const float s : x)
+        {
+            generator->update(s);
+            out.up1.push_back(generator->up1());
+            out.down1.push_back(generator->down1());
+            out.awake += double(generator->awakeBands());
+        }
+        out.awake /= double(x.size());
+        return out;
+    }
+
+    double levelDb(const std::vector<float>& x)
+    {
+        double sum = 0;
+        for (const float s : x)
+        {
+            sum += double(s) * s;
+        }
+        return test::db(sum / double(x.size()));
+    }
+}
+
+int main()
+{
+    const auto x = test::diCorpus(sample_rate);
+    const auto ungated = run(x, 0);
+    const auto gated = run(x, sleep_level);
+
+    test::check(ungated.awake == double(Generator::max_bands),
+                "ungated: all %zu bands run", Generator::max_bands);
+    test::check(gated.awake < 40, "gated: %.1f of %zu bands awake on average (< 40)",
+                gated.awake, Generator::max_bands);
+
+    const double up1 = levelDb(gated.up1) - levelDb(ungated.up1);
+    const double down1 = levelDb(gated.down1) - levelDb(ungated.down1);
+    test::check(std::fabs(up1) < 0.3, "gated up1 level within 0.3 dB of ungated: %+.2f dB", up1);
+    test::check(std::fabs(down1) < 0.3, "gated down1 level within 0.3 dB of ungated: %+.2f dB", down1);
+
+    const double up1_snr = test::snrDb(ungated.up1, gated.up1);
+    const double down1_snr = test::snrDb(ungated.down1, gated.down1);
+    test::check(up1_snr > 20 && down1_snr > 20,
+                "gated vs ungated: up1 %.1f dB, down1 %.1f dB SNR (> 20)", up1_snr, down1_snr);
+
+    // From silence, nothing wakes up and the output is exactly silent
+    {
+        auto generator = std::make_unique<Generator>(sample_rate);
+        generator->setSleepThreshold(sleep_level);
+        generator->reset();
+
+        std::size_t awake = 0;
+        bool silent = true;
+        for (int i = 0; i < 8000; ++i)
+        {
+            generator->update(0);
+            awake += generator->awakeBands();
+            silent = silent && generator->up1() == 0 && generator->down1() == 0 && generator->down2() == 0;
+        }
+        test::check(awake == 0 && silent, "silence after reset(): no band wakes, output is zero");
+    }
+
+    // After a note, every band goes back to sleep once the narrowest
+    // filters have rung down (cutting the note off rings every band)
+    {
+        auto generator = std::make_unique<Generator>(sample_rate);
+        generator->setSleepThreshold(sleep_level);
+        for (const float s : test::tone(220, sample_rate, 4000))
+        {
+            generator->update(s);
+        }
+        const std::size_t playing = generator->awakeBands();
+        for (int i = 0; i < 4000; ++i)
+        {
+            generator->update(0);
+        }
+        test::check(playing > 0 && generator->awakeBands() == 0,
+                    "after a note: %zu bands awake, %zu after 500 ms of silence",
+                    playing, generator->awakeBands());
+    }
+
+    return test::result();
+}
@@ -0,0 +1,51 @@
+# Build and run rules for host tests, shared by OctaveDSP/tests and the
+# ports' tests/ directories
+#
+# Set TESTS and BENCHES (each program is built from <name>.cpp and must end
+# in Test or Bench), add include paths to CPPFLAGS and the headers the
+# programs depend on to HEADERS, then include this file:
+#   HOST_TESTS_DIR = ../../../OctaveDSP/tests
+#   include $(HOST_TESTS_DIR)/HostTests.mk
+#
+#   make          build and run the tests (or: make test)
+#   make bench    build and run the benchmarks
+#   make clean
+#
+# Only needs a C++20 host compiler; gcem comes from the buzzbox port's
+# copy. Override CXX or GCEM_DIR on the command line to use others.
+
+HOST_TESTS_DIR ?= $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+
+CXX ?= g++
+GCEM_DIR ?= $(HOST_TESTS_DIR)/../../src/buzzbox_octa_squawker/lib/gcem/include
+BUILD_DIR ?= build
+
+# The tests check bit-exact equivalences, so no -ffast-math here. The
+# benchmarks default to the ports' flags; add -fno-tree-vectorize for
+# numbers closer to the Cortex-M7, which has no float SIMD.
+CXXFLAGS ?= -O2 -g
+BENCHFLAGS ?= -Ofast -fno-strict-aliasing
+WARNINGS = -Wall -Wextra
+CPPFLAGS += -I$(HOST_TESTS_DIR) -I$(HOST_TESTS_DIR)/.. -I$(GCEM_DIR)
+
+HEADERS += $(wildcard $(HOST_TESTS_DIR)/../Util/*.h) $(HOST_TESTS_DIR)/Test.h $(HOST_TESTS_DIR)/Bench.h
+
+test: $(addprefix $(BUILD_DIR)/,$(TESTS))
+	@set -e; for t in $^; do echo "== $$t"; $$t; done
+
+bench: $(addprefix $(BUILD_DIR)/,$(BENCHES))
+	@set -e; for t in $^; do echo "== $$t"; $$t; done
+
+$(BUILD_DIR)/%Test: %Test.cpp $(HEADERS) | $(BUILD_DIR)
+	$(CXX) -std=c++20 $(WARNINGS) $(CPPFLAGS) $(CXXFLAGS) $< -o $@
+
+$(BUILD_DIR)/%Bench: %Bench.cpp $(HEADERS) | $(BUILD_DIR)
+	$(CXX) -std=c++20 $(WARNINGS) $(CPPFLAGS) $(BENCHFLAGS) $< -o $@
+
+$(BUILD_DIR):
+	mkdir -p $@
+
+clean:
+	rm -rf $(BUILD_DIR)
+
+.PHONY: test bench clean
@@ -0,0 +1,169 @@
+// Per-sample cost of the octave path: the burst on every resample_factor'th
+// sample against MultirateScheduler, as a cycle histogram, and the
+// scheduler's block form against its per-sample form
+//
+// The worst samples, not the average, set how small the audio block can be.
+
+#include "Bench.h"
+#include "Test.h"
+
+#include "Util/Multirate.h"
+#include "Util/OctaveGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 48000;
+    constexpr int runs = 5;
+
+    struct OctaveStage
+    {
+        OctaveGenerator<> octave{sample_rate / resample_factor};
+
+        void begin(float sample)
+        {
+            octave.begin(sample);
+        }
+
+        void step(std::size_t i)
+        {
+            octave.step(i, resample_factor);
+        }
+
+        float end()
+        {
+            octave.end();
+            return octave.up1() + octave.down1() + octave.down2();
+        }
+
+        void process(const float* in, float* out, std::size_t count)
+        {
+            std::array<float, max_low_rate_block> up1, down1, down2;
+            octave.process(in, count, up1.data(), down1.data(), down2.data());
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = up1[i] + down1[i] + down2[i];
+            }
+        }
+    };
+
+    // Percentiles, and the share of samples in each `bucket`-wide bucket
+    void histogram(const char* name, std::vector<std::uint64_t> ticks, std::uint64_t bucket)
+    {
+        std::sort(ticks.begin(), ticks.end());
+        double mean = 0;
+        for (const auto t : ticks)
+        {
+            mean += double(t);
+        }
+        mean /= double(ticks.size());
+
+        const auto at = [&](double fraction)
+        {
+            return ticks[std::size_t(fraction * double(ticks.size() - 1))];
+        };
+        std::printf("  %-10s mean %6.0f  p50 %6llu  p90 %6llu  p99 %6llu  p99.9 %6llu %s\n",
+                    name, mean,
+                    (unsigned long long)at(0.5), (unsigned long long)at(0.9),
+                    (unsigned long long)at(0.99), (unsigned long long)at(0.999), bench::unit());
+
+        std::array<std::size_t, 10> counts{};
+        for (const auto t : ticks)
+        {
+            ++counts[std::min<std::size_t>(t / bucket, counts.size() - 1)];
+        }
+        std::printf("  %-10s", "");
+        for (std::size_t i = 0; i < counts.size(); ++i)
+        {
+            std::printf(" %s%llu:%.1f%%", (i + 1 == counts.size()) ? ">=" : "<",
+                        (unsigned long long)((i + (i + 1 == counts.size() ? 0 : 1)) * bucket),
+                        100.0 * double(counts[i]) / double(ticks.size()));
+        }
+        std::printf("\n");
+    }
+}
+
+int main()
+{
+    const auto x = test::diCorpus(sample_rate, 10);
+    std::vector<std::uint64_t> burst_ticks(x.size());
+    std::vector<std::uint64_t> scheduler_ticks(x.size());
+
+    // Fastest of several runs, per sample
+    for (int run = 0; run < runs; ++run)
+    {
+        auto stage = std::make_unique<OctaveStage>();
+        Decimator2 decimate;
+        Interpolator interpolate;
+        std::array<float, resample_factor> in{};
+        std::array<float, resample_factor> out{};
+
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const std::uint64_t start = bench::ticks();
+            const std::size_t phase = i % resample_factor;
+            in[phase] = x[i];
+            bench::sink = out[phase];
+            if (phase == resample_factor - 1)
+            {
+                stage->begin(decimate(in));
+                for (std::size_t step = 0; step < resample_factor; ++step)
+                {
+                    stage->step(step);
+                }
+                out = interpolate(stage->end());
+            }
+            const std::uint64_t t = bench::ticks() - start;
+            burst_ticks[i] = run ? std::min(burst_ticks[i], t) : t;
+        }
+
+        auto scheduler = std::make_unique<MultirateScheduler<OctaveStage>>();
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const std::uint64_t start = bench::ticks();
+            bench::sink = (*scheduler)(x[i]);
+            const std::uint64_t t = bench::ticks() - start;
+            scheduler_ticks[i] = run ? std::min(scheduler_ticks[i], t) : t;
+        }
+    }
+
+    std::printf("per-sample cost, %zu samples (including the timer)\n", x.size());
+    // Buckets a tenth of the burst's worst case wide
+    const std::uint64_t bucket = std::max<std::uint64_t>(
+        *std::max_element(burst_ticks.begin(), burst_ticks.end()) / 10, 1);
+    histogram("burst", burst_ticks, bucket);
+    histogram("scheduler", scheduler_ticks, bucket);
+
+    std::printf("MultirateScheduler, per sample of a whole corpus\n");
+    std::vector<float> y(x.size());
+    for (const std::size_t block : {48, 256})
+    {
+        auto per_sample = std::make_unique<MultirateScheduler<OctaveStage>>();
+        const double single = bench::best(runs, [&]
+        {
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                y[i] = (*per_sample)(x[i]);
+            }
+        });
+
+        auto blocks = std::make_unique<MultirateScheduler<OctaveStage>>();
+        const double whole = bench::best(runs, [&]
+        {
+            for (std::size_t i = 0; i + block <= x.size(); i += block)
+            {
+                blocks->process(&x[i], &y[i], block);
+            }
+        });
+
+        std::printf("  operator() %6.1f %s, process(%zu) %6.1f %s (%.2fx)\n",
+                    single / double(x.size()), bench::unit(), block,
+                    whole / double(x.size()), bench::unit(), single / whole);
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+// MultirateScheduler against the burst it replaced, and its block form
+// against its per-sample form
+//
+// Both run the octave engine as the ports do. The scheduler gives the same
+// output as running Decimator2, the generator and Interpolator together on
+// every resample_factor'th sample, resample_factor - 1 samples later.
+// process() promises the same output as operator() per sample, so the two
+// must match bit for bit, for any block size, including blocks longer than
+// the scheduler's chunk.
+
+#include "Test.h"
+
+#include "Util/Multirate.h"
+#include "Util/OctaveGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 48000;
+
+    // As the ports' OctaveStage, with both the incremental and block forms
+    struct OctaveStage
+    {
+        OctaveGenerator<> octave{sample_rate / resample_factor};
+
+        void begin(float sample)
+        {
+            octave.begin(sample);
+        }
+
+        void step(std::size_t i)
+        {
+            octave.step(i, resample_factor);
+        }
+
+        float end()
+        {
+            octave.end();
+            return mix(octave.up1(), octave.down1(), octave.down2());
+        }
+
+        void process(const float* in, float* out, std::size_t count)
+        {
+            std::array<float, max_low_rate_block> up1, down1, down2;
+            octave.process(in, count, up1.data(), down1.data(), down2.data());
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = mix(up1[i], down1[i], down2[i]);
+            }
+        }
+
+        void reset()
+        {
+            octave.reset();
+        }
+
+        static float mix(float up1, float down1, float down2)
+        {
+            return up1 * 1.5f + down1 * 2.5f + down2;
+        }
+    };
+
+    using Scheduler = MultirateScheduler<OctaveStage>;
+
+    std::vector<float> perSample(Scheduler& scheduler, const std::vector<float>& x)
+    {
+        std::vector<float> y;
+        for (const float s : x)
+        {
+            y.push_back(scheduler(s));
+        }
+        return y;
+    }
+
+    // Runs x in blocks cycling through `sizes`, in place
+    std::vector<float> blocks(Scheduler& scheduler, const std::vector<float>& x,
+                              std::initializer_list<std::size_t> sizes)
+    {
+        std::vector<float> y = x;
+        std::size_t i = 0;
+        for (auto size = sizes.begin(); i < y.size(); )
+        {
+            const std::size_t n = std::min(*size, y.size() - i);
+            scheduler.process(y.data() + i, y.data() + i, n);
+            i += n;
+            if (++size == sizes.end())
+            {
+                size = sizes.begin();
+            }
+        }
+        return y;
+    }
+
+    // The octave path as the ports ran it before MultirateScheduler: the
+    // whole low-rate sample's work on the last sample of each period
+    std::vector<float> burst(const std::vector<float>& x)
+    {
+        auto stage = std::make_unique<OctaveStage>();
+        Decimator2 decimate;
+        Interpolator interpolate;
+        std::array<float, resample_factor> in{};
+        std::array<float, resample_factor> out{};
+
+        std::vector<float> y;
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const std::size_t phase = i % resample_factor;
+            in[phase] = x[i];
+            y.push_back(out[phase]);
+            if (phase == resample_factor - 1)
+            {
+                stage->begin(decimate(in));
+                for (std::size_t step = 0; step < resample_factor; ++step)
+                {
+                    stage->step(step);
+                }
+                out = interpolate(stage->end());
+            }
+        }
+        return y;
+    }
+
+    // Samples where b, `delay` samples later, differs from a
+    std::size_t mismatches(const std::vector<float>& a, const std::vector<float>& b,
+                           std::size_t delay = 0)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i + delay < b.size(); ++i)
+        {
+            count += (a[i] != b[i + delay]);
+        }
+        return count;
+    }
+
+    void compare(const char* name, const std::vector<float>& x,
+                 std::initializer_list<std::size_t> sizes,
+                 ShifterQuality quality, float sleep_threshold)
+    {
+        // Several KB each, so not on the stack
+        auto reference = std::make_unique<Scheduler>();
+        auto block = std::make_unique<Scheduler>();
+        for (Scheduler* s : {reference.get(), block.get()})
+        {
+            s->stage().octave.setQuality(quality);
+            s->stage().octave.setSleepThreshold(sleep_threshold);
+        }
+
+        const auto want = perSample(*reference, x);
+        const auto got = blocks(*block, x, sizes);
+
+        double energy = 0;
+        for (const float s : want)
+        {
+            energy += double(s) * s;
+        }
+
+        const std::size_t bad = mismatches(want, got);
+        test::check(bad == 0 && energy > 0,
+                    "process() == operator(), %s: %zu of %zu samples differ",
+                    name, bad, x.size());
+    }
+}
+
+int main()
+{
+    const auto x = test::diCorpus(sample_rate, 8);
+
+    {
+        auto scheduler = std::make_unique<Scheduler>();
+        const auto want = burst(x);
+        const auto got = perSample(*scheduler, x);
+        const std::size_t bad = mismatches(want, got, resample_factor - 1);
+        test::check(bad == 0, "operator() == burst, %zu samples later: %zu of %zu samples differ",
+                    resample_factor - 1, bad, x.size());
+    }
+
+    compare("48-sample blocks", x, {48}, ShifterQuality::reference, 0);
+    compare("1-sample blocks", x, {1}, ShifterQuality::reference, 0);
+    compare("odd blocks", x, {7, 1, 33, 5, 100}, ShifterQuality::reference, 0);
+    compare("blocks over one chunk", x, {1000, 385}, ShifterQuality::reference, 0);
+    compare("fast, gated", x, {48, 13}, ShifterQuality::fast, 0.0001f);
+    compare("high, gated", x, {32}, ShifterQuality::high, 0.0001f);
+
+    // After reset(), as from new
+    {
+        auto scheduler = std::make_unique<Scheduler>();
+        auto fresh = std::make_unique<Scheduler>();
+        blocks(*scheduler, x, {48});
+        scheduler->reset();
+
+        const auto want = perSample(*fresh, x);
+        const auto got = blocks(*scheduler, x, {48});
+        const std::size_t bad = mismatches(want, got);
+        test::check(bad == 0, "reset() starts over: %zu of %zu samples differ", bad, x.size());
+    }
+
+    return test::result();
+}
@@ -0,0 +1,132 @@
+// Oversampler against the oversampling the buzzbox fuzz used before it: a
+// linear ramp up and a plain average down at 4x, with a std::vector
+// allocated for every sample. Cost per base-rate sample around a tanh
+// curve, and the worst alias below 20 kHz with a 1975 Hz sine driven hard
+// into it.
+
+#include "Bench.h"
+#include "Test.h"
+
+#include "Util/Oversampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr double base_rate = 48000;
+    constexpr int runs = 5;
+    constexpr float drive = 10;
+
+    float shape(float s)
+    {
+        return std::tanh(drive * s);
+    }
+
+    // As it was in buzzbox_hothouse.h
+    namespace Previous
+    {
+        constexpr int factor = 4;
+
+        inline std::vector<float> upsample(float input)
+        {
+            std::vector<float> output(factor, 0.0f);
+            output[0] = input;
+            for (int i = 1; i < factor; ++i)
+            {
+                output[i] = input * (1.0f - static_cast<float>(i) / factor);
+            }
+            return output;
+        }
+
+        inline float downsample(const std::vector<float>& input)
+        {
+            float sum = 0.0f;
+            for (float sample : input)
+            {
+                sum += sample;
+            }
+            return sum / input.size();
+        }
+
+        float process(float s)
+        {
+            std::vector<float> oversampled = upsample(s);
+            for (float& sample : oversampled)
+            {
+                sample = shape(sample);
+            }
+            return downsample(oversampled);
+        }
+    }
+
+    // Worst component below 20 kHz at the frequency a harmonic above the
+    // Nyquist frequency folds to, relative to the fundamental. 1975 Hz fits
+    // a whole number of cycles into 19200 samples, and so do its folded
+    // harmonics, none of which land on a harmonic.
+    double worstAliasDb(const std::vector<float>& y, std::size_t from, double f)
+    {
+        const std::size_t count = 19200;
+        const double fundamental = test::toneAmplitude(&y[from], count, f, base_rate);
+        double worst = 0;
+        for (int k = 2; k * f < 20 * base_rate; ++k)
+        {
+            const double harmonic = k * f;
+            if (harmonic < base_rate / 2)
+            {
+                continue;
+            }
+            const double folded = std::fabs(harmonic - base_rate * std::round(harmonic / base_rate));
+            if (folded < 20000)
+            {
+                worst = std::max(worst, test::toneAmplitude(&y[from], count, folded, base_rate));
+            }
+        }
+        return 20 * std::log10(worst / fundamental + 1e-30);
+    }
+}
+
+int main()
+{
+    constexpr double f = 1975;
+    const auto x = test::tone(f, base_rate, 4 * 19200, 0.8f);
+    std::vector<float> y(x.size());
+    const std::size_t from = 2 * 19200;
+
+    std::printf("%.0f Hz sine into tanh(%.0f x), per 48 kHz sample\n", f, double(drive));
+
+    const double previous = bench::best(runs, [&]
+    {
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            y[i] = Previous::process(x[i]);
+        }
+    });
+    std::printf("  %-32s %6.1f %s, worst alias %6.1f dB\n", "previous 4x (vector, ramp)",
+                previous / double(x.size()), bench::unit(), worstAliasDb(y, from, f));
+
+    for (const std::size_t ratio : {2, 4, 8})
+    {
+        for (const std::size_t block : {1, 48})
+        {
+            Oversampler oversampler(ratio);
+            std::vector<float> buffer(block * Oversampler::max_ratio);
+            const double ticks = bench::best(runs, [&]
+            {
+                oversampler.reset();
+                for (std::size_t i = 0; i + block <= x.size(); i += block)
+                {
+                    oversampler.process(&x[i], &y[i], block, buffer.data(), shape);
+                }
+            });
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "Oversampler %zux, %zu-sample blocks", ratio, block);
+            std::printf("  %-32s %6.1f %s, worst alias %6.1f dB\n", label,
+                        ticks / double(x.size()), bench::unit(), worstAliasDb(y, from, f));
+        }
+    }
+
+    return 0;
+}
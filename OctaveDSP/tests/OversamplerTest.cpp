@@ -0,0 +1,205 @@
+// Oversampler's filters against its documented response: flat to 20 kHz,
+// and at least 70 dB down from 28 kHz up, for images on the way up and
+// aliases on the way down, at every ratio. And no heap allocation while
+// processing.
+//
+// Tones are multiples of 10 Hz and levels are measured over 4800 base-rate
+// samples, so every tone fits a whole number of cycles into the window.
+
+#include "Test.h"
+
+#include "Util/Oversampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Counts every allocation made while `counting` is set. The default
+// operator delete frees with std::free, so it pairs with this.
+namespace
+{
+    bool counting = false;
+    std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    allocations += counting ? 1 : 0;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+namespace
+{
+    constexpr double base_rate = 48000;
+    constexpr std::size_t window = 4800;
+    constexpr std::size_t block = 48;
+
+    constexpr double passband_hz = 20000;
+    constexpr double stopband_hz = 28000;
+    constexpr double passband_db = 0.05;
+    constexpr double stopband_db = -70;
+
+    // Upsamples `in` in blocks and returns the oversampled signal
+    std::vector<float> upsample(Oversampler& oversampler, const std::vector<float>& in)
+    {
+        const std::size_t ratio = oversampler.ratio();
+        std::vector<float> out(in.size() * ratio);
+        for (std::size_t i = 0; i < in.size(); i += block)
+        {
+            oversampler.upsample(in.data() + i, block, out.data() + i * ratio);
+        }
+        return out;
+    }
+
+    std::vector<float> downsample(Oversampler& oversampler, std::vector<float> in)
+    {
+        const std::size_t ratio = oversampler.ratio();
+        std::vector<float> out(in.size() / ratio);
+        for (std::size_t i = 0; i < out.size(); i += block)
+        {
+            oversampler.downsample(in.data() + i * ratio, block, out.data() + i);
+        }
+        return out;
+    }
+
+    double rms(const float* x, std::size_t count)
+    {
+        double sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sum += double(x[i]) * x[i];
+        }
+        return std::sqrt(sum / double(count));
+    }
+
+    // Round trip through process() with no shaping, over the passband
+    void passband(std::size_t ratio)
+    {
+        double worst = 0;
+        for (double f = 50; f <= passband_hz; f += 50)
+        {
+            Oversampler oversampler(ratio);
+            auto x = test::tone(f, base_rate, 2 * window);
+            std::vector<float> buffer(block * Oversampler::max_ratio);
+            for (std::size_t i = 0; i < x.size(); i += block)
+            {
+                oversampler.process(x.data() + i, x.data() + i, block, buffer.data(),
+                                    [](float s) { return s; });
+            }
+
+            const double gain = test::toneAmplitude(x.data() + window, window, f, base_rate) / 0.5;
+            worst = std::max(worst, std::fabs(20 * std::log10(gain)));
+        }
+        test::check(worst < passband_db, "%zux round trip flat to 20 kHz: worst %.4f dB (< %.2f)",
+                    ratio, worst, passband_db);
+    }
+
+    // Images of passband tones in the upsampled signal
+    void images(std::size_t ratio)
+    {
+        const double rate = base_rate * double(ratio);
+        double worst = -300;
+        for (double f = 50; f <= passband_hz; f += 250)
+        {
+            Oversampler oversampler(ratio);
+            const auto up = upsample(oversampler, test::tone(f, base_rate, 2 * window));
+            const float* tail = up.data() + window * ratio;
+            const double level = test::toneAmplitude(tail, window * ratio, f, rate);
+
+            for (double image = base_rate - f; image < rate / 2; image += base_rate)
+            {
+                for (const double g : {image, image + 2 * f})
+                {
+                    if (g < rate / 2)
+                    {
+                        const double a = test::toneAmplitude(tail, window * ratio, g, rate);
+                        worst = std::max(worst, 20 * std::log10(a / level + 1e-30));
+                    }
+                }
+            }
+        }
+        test::check(worst < stopband_db, "%zux upsample images: worst %.1f dB (< %.0f)",
+                    ratio, worst, stopband_db);
+    }
+
+    // Tones above 28 kHz at the oversampled rate, which would alias into
+    // the base band
+    void aliases(std::size_t ratio)
+    {
+        const double rate = base_rate * double(ratio);
+        double worst = -300;
+        for (double f = stopband_hz; f < rate / 2; f += 370)
+        {
+            Oversampler oversampler(ratio);
+            const auto down = downsample(oversampler, test::tone(f, rate, 2 * window * ratio));
+            const double level = rms(down.data() + window, window) * std::sqrt(2.0) / 0.5;
+            worst = std::max(worst, 20 * std::log10(level + 1e-30));
+        }
+        test::check(worst < stopband_db, "%zux downsample aliases from 28 kHz up: worst %.1f dB (< %.0f)",
+                    ratio, worst, stopband_db);
+    }
+
+    // Runs every ratio through every entry point, per sample and in blocks,
+    // with a shaper that doesn't allocate either
+    std::size_t allocationsWhileProcessing()
+    {
+        Oversampler oversampler;
+        std::array<float, 64> in{};
+        std::array<float, 64> out{};
+        std::array<float, 64 * Oversampler::max_ratio> buffer{};
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            in[i] = std::sin(0.1f * float(i));
+        }
+
+        counting = true;
+        allocations = 0;
+        for (const std::size_t ratio : {1, 2, 4, 8})
+        {
+            oversampler.setRatio(ratio);
+            for (const std::size_t count : {1, 48, 64})
+            {
+                for (int repeat = 0; repeat < 100; ++repeat)
+                {
+                    oversampler.process(in.data(), out.data(), count, buffer.data(),
+                                        [](float s) { return std::tanh(4 * s); });
+                    oversampler.upsample(in.data(), count, buffer.data());
+                    oversampler.downsample(buffer.data(), count, out.data());
+                }
+            }
+            oversampler.reset();
+        }
+        counting = false;
+        return allocations;
+    }
+}
+
+int main()
+{
+    for (const std::size_t ratio : {2, 4, 8})
+    {
+        passband(ratio);
+        images(ratio);
+        aliases(ratio);
+    }
+
+    // Check that the counter sees allocations at all
+    counting = true;
+    allocations = 0;
+    auto probe = std::make_unique<std::vector<float>>(4);
+    counting = false;
+    test::check(allocations > 0, "allocation counter works (%zu for a vector)", allocations);
+
+    const std::size_t during = allocationsWhileProcessing();
+    test::check(during == 0, "no allocations while processing: %zu", during);
+
+    return test::result();
+}
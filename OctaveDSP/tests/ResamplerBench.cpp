@@ -0,0 +1,167 @@
+// Decimator2 and Interpolator against the same filters in direct form on a
+// power-of-two ring buffer (like q::ring_buffer), computing every tap of
+// every output, including those that decimation then throws away, as the
+// resamplers did before the polyphase classes. Cost per full-rate (48 kHz)
+// sample.
+
+#include "Bench.h"
+#include "Test.h"
+
+#include "Util/Multirate.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
+#include <vector>
+
+namespace
+{
+    constexpr int runs = 7;
+
+    template <std::size_t Taps>
+    class RingFir
+    {
+    public:
+        explicit RingFir(std::initializer_list<float> half)
+        {
+            const std::vector<float> first(half);
+            for (std::size_t k = 0; k < Taps; ++k)
+            {
+                _h[k] = (k < first.size()) ? first[k] : first[Taps - 1 - k];
+            }
+        }
+
+        float operator()(float s)
+        {
+            _pos = (_pos + 1) & mask;
+            _x[_pos] = s;
+            float sum = 0;
+            for (std::size_t k = 0; k < Taps; ++k)
+            {
+                sum += _h[k] * _x[(_pos - k) & mask];
+            }
+            return sum;
+        }
+
+    private:
+        static constexpr std::size_t size = std::bit_ceil(Taps);
+        static constexpr std::size_t mask = size - 1;
+
+        std::array<float, Taps> _h{};
+        std::array<float, size> _x{};
+        std::size_t _pos = 0;
+    };
+
+    class DirectDecimator
+    {
+    public:
+        float operator()(std::span<const float, resample_factor> s)
+        {
+            // Keeps the first of each three stage 1 outputs, and the first
+            // of each two stage 2 outputs, as Decimator2 does
+            float out = 0;
+            for (std::size_t i = 0; i < resample_factor; ++i)
+            {
+                const float y = stage1(s[i]);
+                if (i % 3 == 0)
+                {
+                    const float z = stage2(y);
+                    out = (i == 0) ? z : out;
+                }
+            }
+            return out;
+        }
+
+    private:
+        RingFir<21> stage1{
+            0.000066177472224418f, 0.0009613901552378511f, 0.003835090815380887f,
+            0.010496532623165526f, 0.02272703591356282f, 0.041464390530886956f,
+            0.06591039391505207f, 0.09309984953947406f, 0.11829177835273737f,
+            0.13620590247679107f, 0.14270010010002276f};
+        RingFir<15> stage2{
+            -0.00299995f, 0.0f, 0.01858487f, 0.0f, -0.06984829f, 0.0f,
+            0.30421664f, 0.5f};
+    };
+
+    class DirectInterpolator
+    {
+    public:
+        std::array<float, resample_factor> operator()(float s)
+        {
+            std::array<float, resample_factor> out;
+            std::size_t n = 0;
+            for (const float u : {s, 0.0f})
+            {
+                const float v = stage1(u);
+                for (const float w : {v, 0.0f, 0.0f})
+                {
+                    out[n++] = stage2(w);
+                }
+            }
+            return out;
+        }
+
+    private:
+        RingFir<49> stage1{
+            -0.0028536199247471473f, -0.015961858776449508f, -0.040326725115203695f,
+            -0.056128740058266235f, -0.036134596458820015f, 0.011026026040094625f,
+            0.033522051189265496f, 0.003198795994721635f, -0.031442224275585025f,
+            -0.01108582057161854f, 0.03258337681750486f, 0.01951384497860086f,
+            -0.03538414864961937f, -0.030860282826182514f, 0.038811868988079715f,
+            0.04707993944078406f, -0.042204493894155204f, -0.07155908583004919f,
+            0.045128824129776035f, 0.1129220770668398f, -0.04736995557907843f,
+            -0.2033122562119347f, 0.048831901671617876f, 0.6336728217960803f,
+            0.9507771467941135f};
+        RingFir<33> stage2{
+            0.00036440608905813593f, 0.001112114188613258f, 0.001762424830497545f,
+            0.0005821260464558225f, -0.005449383064836152f, -0.019627176246818184f,
+            -0.043244023722481956f, -0.07276547446584428f, -0.09801301258361905f,
+            -0.10310036386076359f, -0.0709695783332148f, 0.009420000864297772f,
+            0.13604229993913602f, 0.2904591843823435f, 0.4407091552750118f,
+            0.5503466630244301f, 0.590541634315722f};
+    };
+
+    template <typename Decimator, typename Interpolator>
+    void time(const char* name, const std::vector<float>& x)
+    {
+        std::vector<float> low(x.size() / resample_factor);
+        std::vector<float> y(x.size());
+
+        Decimator decimator;
+        const double down = bench::best(runs, [&]
+        {
+            for (std::size_t i = 0; i < low.size(); ++i)
+            {
+                low[i] = decimator(std::span<const float, resample_factor>(
+                    &x[i * resample_factor], resample_factor));
+            }
+        });
+
+        Interpolator interpolator;
+        const double up = bench::best(runs, [&]
+        {
+            for (std::size_t i = 0; i < low.size(); ++i)
+            {
+                const auto out = interpolator(low[i]);
+                std::copy(out.begin(), out.end(), &y[i * resample_factor]);
+            }
+        });
+        bench::sink = y[y.size() / 2];
+
+        const double samples = double(low.size() * resample_factor);
+        std::printf("  %-24s decimate %5.1f %s, interpolate %5.1f %s\n",
+                    name, down / samples, bench::unit(), up / samples, bench::unit());
+    }
+}
+
+int main()
+{
+    const auto x = test::diCorpus(48000, 10);
+
+    std::printf("per 48 kHz sample\n");
+    time<DirectDecimator, DirectInterpolator>("direct form, ring buffer", x);
+    time<Decimator2, Interpolator>("Decimator2/Interpolator", x);
+
+    return 0;
+}
@@ -0,0 +1,297 @@
+// Decimator2 and Interpolator: their incremental and block forms against
+// operator(), the polyphase filters against the same filters in direct
+// form, and their frequency response
+
+#include "Test.h"
+
+#include "Util/Multirate.h"
+
+#include <array>
+#include <cmath>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace
+{
+    constexpr double full_rate = 48000;
+    constexpr double low_rate = full_rate / resample_factor;
+
+    // Symmetric FIR that computes every tap of every output, the way the
+    // resamplers did before the polyphase classes
+    class DirectFir
+    {
+    public:
+        DirectFir(std::initializer_list<float> half, std::size_t taps)
+          : _h(taps), _x(taps, 0.0f)
+        {
+            const std::vector<float> first(half);
+            for (std::size_t k = 0; k < taps; ++k)
+            {
+                _h[k] = (k < first.size()) ? first[k] : first[taps - 1 - k];
+            }
+        }
+
+        float operator()(float s)
+        {
+            _x.pop_back();
+            _x.push_front(s);
+            float sum = 0;
+            for (std::size_t k = 0; k < _h.size(); ++k)
+            {
+                sum += _h[k] * _x[k];
+            }
+            return sum;
+        }
+
+    private:
+        std::vector<float> _h;
+        std::deque<float> _x;
+    };
+
+    // The coefficients in Multirate.h
+    DirectFir decimatorStage1()
+    {
+        return DirectFir({
+            0.000066177472224418f, 0.0009613901552378511f, 0.003835090815380887f,
+            0.010496532623165526f, 0.02272703591356282f, 0.041464390530886956f,
+            0.06591039391505207f, 0.09309984953947406f, 0.11829177835273737f,
+            0.13620590247679107f, 0.14270010010002276f}, 21);
+    }
+
+    DirectFir decimatorStage2()
+    {
+        return DirectFir({
+            -0.00299995f, 0.0f, 0.01858487f, 0.0f, -0.06984829f, 0.0f,
+            0.30421664f, 0.5f}, 15);
+    }
+
+    DirectFir interpolatorStage1()
+    {
+        return DirectFir({
+            -0.0028536199247471473f, -0.015961858776449508f, -0.040326725115203695f,
+            -0.056128740058266235f, -0.036134596458820015f, 0.011026026040094625f,
+            0.033522051189265496f, 0.003198795994721635f, -0.031442224275585025f,
+            -0.01108582057161854f, 0.03258337681750486f, 0.01951384497860086f,
+            -0.03538414864961937f, -0.030860282826182514f, 0.038811868988079715f,
+            0.04707993944078406f, -0.042204493894155204f, -0.07155908583004919f,
+            0.045128824129776035f, 0.1129220770668398f, -0.04736995557907843f,
+            -0.2033122562119347f, 0.048831901671617876f, 0.6336728217960803f,
+            0.9507771467941135f}, 49);
+    }
+
+    DirectFir interpolatorStage2()
+    {
+        return DirectFir({
+            0.00036440608905813593f, 0.001112114188613258f, 0.001762424830497545f,
+            0.0005821260464558225f, -0.005449383064836152f, -0.019627176246818184f,
+            -0.043244023722481956f, -0.07276547446584428f, -0.09801301258361905f,
+            -0.10310036386076359f, -0.0709695783332148f, 0.009420000864297772f,
+            0.13604229993913602f, 0.2904591843823435f, 0.4407091552750118f,
+            0.5503466630244301f, 0.590541634315722f}, 33);
+    }
+
+    // Decimator2 in direct form: filter at 48 kHz, keep every third output
+    // (the first of each three), filter at 16 kHz, keep every other one
+    std::vector<float> directDecimate(const std::vector<float>& x)
+    {
+        auto stage1 = decimatorStage1();
+        auto stage2 = decimatorStage2();
+        std::vector<float> y;
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const float a = stage1(x[i]);
+            if (i % 3 == 0)
+            {
+                const float b = stage2(a);
+                if (i % 6 == 0)
+                {
+                    y.push_back(b);
+                }
+            }
+        }
+        return y;
+    }
+
+    // Interpolator in direct form: zero-stuff by 2 and filter, zero-stuff
+    // by 3 and filter
+    std::vector<float> directInterpolate(const std::vector<float>& x)
+    {
+        auto stage1 = interpolatorStage1();
+        auto stage2 = interpolatorStage2();
+        std::vector<float> y;
+        for (const float s : x)
+        {
+            for (const float u : {s, 0.0f})
+            {
+                const float v = stage1(u);
+                for (const float w : {v, 0.0f, 0.0f})
+                {
+                    y.push_back(stage2(w));
+                }
+            }
+        }
+        return y;
+    }
+
+    std::vector<float> decimate(const std::vector<float>& x)
+    {
+        Decimator2 decimator;
+        std::vector<float> y;
+        for (std::size_t i = 0; i + resample_factor <= x.size(); i += resample_factor)
+        {
+            y.push_back(decimator(std::span<const float, resample_factor>(&x[i], resample_factor)));
+        }
+        return y;
+    }
+
+    std::vector<float> interpolate(const std::vector<float>& x)
+    {
+        Interpolator interpolator;
+        std::vector<float> y;
+        for (const float s : x)
+        {
+            for (const float v : interpolator(s))
+            {
+                y.push_back(v);
+            }
+        }
+        return y;
+    }
+
+    void forms(const std::vector<float>& x)
+    {
+        const auto want = decimate(x);
+
+        Decimator2 pushed;
+        std::vector<float> got;
+        for (const float s : x)
+        {
+            if (pushed.push(s))
+            {
+                got.push_back(pushed.output());
+            }
+        }
+        test::check(got == want, "Decimator2 push() == operator()");
+
+        // Blocks that start and end mid-period, and a period boundary
+        // handed over between push() and operator()
+        Decimator2 blocks;
+        got.assign(x.size() / resample_factor, 0);
+        std::size_t produced = 0;
+        std::size_t i = 0;
+        for (const std::size_t n : {1, 7, 48, 5, 100, 11})
+        {
+            produced += blocks.process(&x[i], n, &got[produced]);
+            i += n;
+        }
+        produced += blocks.process(&x[i], x.size() - i, &got[produced]);
+        test::check(produced == want.size() && got == want, "Decimator2 process() == operator()");
+
+        const auto low = want;
+        const auto up = interpolate(low);
+
+        Interpolator incremental;
+        std::vector<float> next;
+        for (const float s : low)
+        {
+            incremental.push(s);
+            for (std::size_t p = 0; p < resample_factor; ++p)
+            {
+                next.push_back(incremental.next());
+            }
+        }
+        test::check(next == up, "Interpolator push()/next() == operator()");
+
+        Interpolator block;
+        std::vector<float> processed(low.size() * resample_factor);
+        block.process(low.data(), low.size(), processed.data());
+        test::check(processed == up, "Interpolator process() == operator()");
+    }
+
+    void direct(const std::vector<float>& x)
+    {
+        const auto low = decimate(x);
+        const double decimator = test::snrDb(directDecimate(x), low);
+        test::check(decimator > 120, "Decimator2 vs direct form: %.1f dB SNR (> 120)", decimator);
+
+        const double interpolator = test::snrDb(directInterpolate(low), interpolate(low));
+        test::check(interpolator > 120, "Interpolator vs direct form: %.1f dB SNR (> 120)", interpolator);
+    }
+
+    double toDb(double gain)
+    {
+        return 20 * std::log10(gain + 1e-30);
+    }
+
+    // Passband within the filters' 3 dB ripple, and aliases that land in
+    // the passband 78 dB down. Tones are multiples of 100 Hz over 800
+    // low-rate samples, so each fits a whole number of cycles.
+    void decimatorResponse()
+    {
+        constexpr std::size_t window = 800;
+        double lowest = 0, highest = -300, alias = -300;
+        for (double f = 100; f < full_rate / 2; f += 100)
+        {
+            const auto y = decimate(test::tone(f, full_rate, 2 * window * resample_factor));
+            const double folded = std::fabs(f - low_rate * std::round(f / low_rate));
+            const double level = toDb(test::toneAmplitude(&y[window], window, folded, low_rate) / 0.5);
+            if (f <= 1800)
+            {
+                lowest = std::min(lowest, level);
+                highest = std::max(highest, level);
+            }
+            else if (f >= low_rate - 1800 && folded <= 1800)
+            {
+                alias = std::max(alias, level);
+            }
+        }
+        test::check(lowest > -1.5 && highest < 1.5,
+                    "Decimator2 passband 0-1800 Hz: %+.2f to %+.2f dB (within 1.5)", lowest, highest);
+        test::check(alias < -78, "Decimator2 aliases into 0-1800 Hz: worst %.1f dB (< -78)", alias);
+    }
+
+    // Passband within the two stages' 3 dB ripple each, and the images of
+    // passband tones 80 dB down
+    void interpolatorResponse()
+    {
+        constexpr std::size_t window = 800;
+        double lowest = 0, highest = -300, image = -300;
+        for (double f = 100; f <= 3600; f += 100)
+        {
+            const auto y = interpolate(test::tone(f, low_rate, 2 * window));
+            const float* tail = &y[window * resample_factor];
+            const std::size_t count = window * resample_factor;
+            const double level = toDb(test::toneAmplitude(tail, count, f, full_rate) / 0.5);
+            lowest = std::min(lowest, level);
+            highest = std::max(highest, level);
+
+            for (double k = low_rate; k < full_rate / 2 + f; k += low_rate)
+            {
+                for (const double g : {k - f, k + f})
+                {
+                    if (g < full_rate / 2)
+                    {
+                        const double a = toDb(test::toneAmplitude(tail, count, g, full_rate) / 0.5);
+                        image = std::max(image, a - level);
+                    }
+                }
+            }
+        }
+        test::check(lowest > -3 && highest < 3,
+                    "Interpolator passband 0-3600 Hz: %+.2f to %+.2f dB (within 3)", lowest, highest);
+        test::check(image < -80, "Interpolator images: worst %.1f dB (< -80)", image);
+    }
+}
+
+int main()
+{
+    const auto x = test::diCorpus(full_rate, 4);
+
+    forms(x);
+    direct(x);
+    decimatorResponse();
+    interpolatorResponse();
+
+    return test::result();
+}
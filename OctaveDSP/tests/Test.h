@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <numbers>
+#include <random>
+#include <vector>
+
+//=============================================================================
+// Helpers shared by the host tests. Each test program runs its checks,
+// prints one line per check and returns non-zero if any of them failed.
+namespace test
+{
+    inline int failures = 0;
+
+    // Records a check; the message is printf-style and should carry the
+    // measured value, so the log shows how much margin there is
+    inline void check(bool ok, const char* format, ...)
+    {
+        std::printf("%s ", ok ? "  ok  " : "  FAIL");
+        std::va_list args;
+        va_start(args, format);
+        std::vprintf(format, args);
+        va_end(args);
+        std::printf("\n");
+        failures += ok ? 0 : 1;
+    }
+
+    inline int result()
+    {
+        std::printf(failures ? "%d check(s) failed\n" : "all checks passed\n", failures);
+        return failures ? 1 : 0;
+    }
+
+    inline double db(double ratio)
+    {
+        return 10 * std::log10(ratio);
+    }
+
+    // Signal-to-noise ratio of `x` against `ref`, in dB, from sample `from`
+    inline double snrDb(const std::vector<float>& ref, const std::vector<float>& x,
+                        std::size_t from = 0)
+    {
+        double signal = 0;
+        double noise = 0;
+        for (std::size_t i = from; i < ref.size() && i < x.size(); ++i)
+        {
+            const double d = double(x[i]) - ref[i];
+            signal += double(ref[i]) * ref[i];
+            noise += d * d;
+        }
+        return db(signal / (noise + 1e-300));
+    }
+
+    // Amplitude of the `freq` component of x[0, count). Exact (no leakage
+    // from other components) when every tone in x fits a whole number of
+    // cycles into `count` samples.
+    inline double toneAmplitude(const float* x, std::size_t count, double freq,
+                                double sample_rate)
+    {
+        const double w = 2 * std::numbers::pi * freq / sample_rate;
+        std::complex<double> sum = 0;
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            sum += double(x[n]) * std::polar(1.0, -w * double(n));
+        }
+        return 2 * std::abs(sum) / double(count);
+    }
+
+    inline std::vector<float> tone(double freq, double sample_rate,
+                                   std::size_t count, float amplitude = 0.5f)
+    {
+        std::vector<float> x(count);
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            x[n] = amplitude * float(std::sin(2 * std::numbers::pi * freq * double(n) / sample_rate));
+        }
+        return x;
+    }
+
+    // Plucked-string DI corpus (Karplus-Strong notes over the guitar range,
+    // some followed by near-silent gaps) at `sample_rate`
+    inline std::vector<float> diCorpus(float sample_rate, int notes = 30)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> u(0, 1);
+        std::vector<float> x;
+        for (int note = 0; note < notes; ++note)
+        {
+            const float freq = 82.41f * std::pow(2.0f, int(u(rng) * 36) / 12.0f);
+            const int length = int(sample_rate * (0.3f + 1.2f * u(rng)));
+            const int gap = (u(rng) < 0.3f) ? int(sample_rate * u(rng)) : 0;
+            const float amplitude = 0.1f + 0.4f * u(rng);
+
+            std::vector<float> string(std::size_t(sample_rate / freq));
+            for (auto& s : string)
+            {
+                s = u(rng) - 0.5f;
+            }
+            for (int k = 0; k < length; ++k)
+            {
+                const std::size_t i = k % string.size();
+                const std::size_t j = (k + 1) % string.size();
+                const float v = string[i];
+                string[i] = 0.999f * 0.5f * (string[i] + string[j]);
+                x.push_back(amplitude * v);
+            }
+            for (int k = 0; k < gap; ++k)
+            {
+                x.push_back(3e-5f * (u(rng) - 0.5f));
+            }
+        }
+        return x;
+    }
+}
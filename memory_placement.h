@@ -0,0 +1,63 @@
+// memory_placement.h
+// Build-time memory placement policy for large DSP buffers
+//
+// The STM32H750 on the Daisy Seed has several RAM regions, and where a hot
+// buffer lands changes throughput a lot:
+//
+//   DTCM  - 128KB at 0x20000000, zero wait state, not cached (fastest).
+//           libDaisy also keeps the stack at the top of this region.
+//   AXI   - 512KB at 0x24000000, cached. libDaisy's default .bss/.data.
+//   D2    - 288KB at 0x30000000, cached. libDaisy puts DMA buffers here.
+//   SDRAM - 64MB at 0xC0000000, cached but slow on a cache miss.
+//
+// The regions map onto the output sections already provided by the libDaisy
+// linker script (.dtcmram_bss, .bss, .sram1_bss and .sdram_bss), so no custom
+// linker script is needed. Plain buffers in DTCM, D2 and SDRAM are NOLOAD
+// and are NOT zeroed at startup; clear them in main() before use (after
+// hw.Init() for SDRAM).
+//
+// Objects with constructors are built by __libc_init_array before main(),
+// so before hw.Init() has brought up the FMC: one placed in SDRAM hard-faults
+// at boot. They can go in DTCM, AXI or D2. When the Makefile chooses the
+// region of a constructed object, check it with MEM_CONSTRUCTIBLE:
+//   static_assert(MEM_CONSTRUCTIBLE(MY_ENGINE_MEM),
+//                 "MY_ENGINE_MEM: SDRAM isn't up when constructors run");
+//
+// Usage:
+//   float MEM_PLACE(DTCM) table[1024];
+//
+// Or let the Makefile choose the region for a buffer:
+//   #ifndef MY_BUFFER_MEM
+//   #define MY_BUFFER_MEM AXI
+//   #endif
+//   float MEM_PLACE(MY_BUFFER_MEM) buffer[32768];
+//
+//   make MY_BUFFER_MEM=SDRAM
+//
+// memory_report.py in the repository root checks the resulting ELF against
+// each region's budget after linking.
+
+#pragma once
+#ifndef MEMORY_PLACEMENT_H
+#define MEMORY_PLACEMENT_H
+
+#define MEM_SECTION_DTCM __attribute__((section(".dtcmram_bss")))
+#define MEM_SECTION_AXI
+#define MEM_SECTION_D2 __attribute__((section(".sram1_bss")))
+#define MEM_SECTION_SDRAM __attribute__((section(".sdram_bss")))
+
+// Two levels so that a region passed in as a macro (e.g. -DMY_BUFFER_MEM=DTCM)
+// is expanded before it is pasted onto MEM_SECTION_
+#define MEM_PLACE(region) MEM_PLACE_EXPAND(region)
+#define MEM_PLACE_EXPAND(region) MEM_SECTION_##region
+
+// 1 for the regions that are usable while the static constructors run
+#define MEM_CONSTRUCTIBLE_DTCM 1
+#define MEM_CONSTRUCTIBLE_AXI 1
+#define MEM_CONSTRUCTIBLE_D2 1
+#define MEM_CONSTRUCTIBLE_SDRAM 0
+
+#define MEM_CONSTRUCTIBLE(region) MEM_CONSTRUCTIBLE_EXPAND(region)
+#define MEM_CONSTRUCTIBLE_EXPAND(region) MEM_CONSTRUCTIBLE_##region
+
+#endif  // MEMORY_PLACEMENT_H
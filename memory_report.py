@@ -0,0 +1,250 @@
+#!/usr/bin/env python
+"""
+Reports how much of each Daisy Seed memory region a linked firmware uses,
+and exits with an error if any region is over its budget.
+
+The linker only catches outright overflows of the regions it knows about.
+This report also accounts for space that has to stay free at runtime (e.g.
+the stack at the top of DTCM), so a build that links but would crash on
+the pedal fails here instead.
+
+It also summarizes the startup work that scales with the memory map (data
+copied from flash, .bss zeroed, static constructors) and whether the heap
+is linked at all, and can list the largest objects in each region.
+
+Example:
+    python memory_report.py build/venus_hothouse.elf
+    python memory_report.py build/venus_hothouse.elf --reserve DTCM=32K
+    python memory_report.py build/earth_hothouse.elf --symbols 5
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# name: (origin, length) for the STM32H750 as laid out by libDaisy
+REGIONS = {
+    "ITCM": (0x00000000, 64 * 1024),
+    "FLASH": (0x08000000, 128 * 1024),
+    "DTCM": (0x20000000, 128 * 1024),
+    "AXI": (0x24000000, 512 * 1024),
+    "D2": (0x30000000, 288 * 1024),
+    "D3": (0x38000000, 64 * 1024),
+    "QSPI": (0x90000000, 8 * 1024 * 1024),
+    "SDRAM": (0xC0000000, 64 * 1024 * 1024),
+}
+
+# Space that is in use at runtime but does not show up as a section
+DEFAULT_RESERVE = {
+    "DTCM": 16 * 1024,  # main stack, grows down from the top of DTCM
+}
+
+SECTION_PATTERN = re.compile(
+    r"^\s*\d+\s+(\S+)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+([0-9a-fA-F]+)"
+)
+
+SYMBOL_PATTERN = re.compile(r"^([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+(\S)\s+(.+)$")
+
+# Entry points that pull the allocator in when anything calls them
+HEAP_SYMBOLS = ("malloc", "_malloc_r", "operator new(unsigned int)", "_sbrk")
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(
+        description="Report per-region memory use of a Daisy firmware ELF."
+    )
+    parser.add_argument("elf", help="Linked firmware (*.elf).")
+    parser.add_argument(
+        "--objdump",
+        default="arm-none-eabi-objdump",
+        help="objdump executable for the target toolchain.",
+    )
+    parser.add_argument(
+        "--nm",
+        default="arm-none-eabi-nm",
+        help="nm executable for the target toolchain.",
+    )
+    parser.add_argument(
+        "--symbols",
+        type=int,
+        default=0,
+        metavar="N",
+        help="Also list the N largest objects in each region.",
+    )
+    parser.add_argument(
+        "--reserve",
+        action="append",
+        default=[],
+        metavar="REGION=SIZE",
+        help="Bytes to keep free in a region, e.g. DTCM=32K. Repeatable.",
+    )
+    return parser.parse_args()
+
+
+def parse_size(text):
+    """
+    Parses a byte count with an optional K or M suffix.
+    """
+    text = text.strip().upper()
+    scale = 1
+    if text.endswith("K"):
+        scale, text = 1024, text[:-1]
+    elif text.endswith("M"):
+        scale, text = 1024 * 1024, text[:-1]
+    return int(text, 0) * scale
+
+
+def region_of(address):
+    for name, (origin, length) in REGIONS.items():
+        if origin <= address < origin + length:
+            return name
+    return None
+
+
+def read_sections(objdump, elf):
+    """
+    Returns (name, size, vma, lma, flags) for every section in the ELF.
+    """
+    output = subprocess.run(
+        [objdump, "-h", elf], check=True, capture_output=True, text=True
+    ).stdout.splitlines()
+
+    sections = []
+    for line, flags in zip(output, output[1:]):
+        match = SECTION_PATTERN.match(line)
+        if match:
+            name, size, vma, lma = match.groups()
+            sections.append(
+                (name, int(size, 16), int(vma, 16), int(lma, 16), flags)
+            )
+    return sections
+
+
+def tally(sections):
+    """
+    Sums section sizes per region. Initialized data counts twice: once where
+    it runs (VMA) and once where its initial values are stored (LMA).
+    """
+    used = {name: 0 for name in REGIONS}
+    placement = {name: [] for name in REGIONS}
+
+    for name, size, vma, lma, flags in sections:
+        if "ALLOC" not in flags or size == 0:
+            continue
+
+        run_region = region_of(vma)
+        if run_region:
+            used[run_region] += size
+            placement[run_region].append((name, size))
+
+        load_region = region_of(lma)
+        if "LOAD" in flags and load_region and load_region != run_region:
+            used[load_region] += size
+            placement[load_region].append((name + " (init)", size))
+
+    return used, placement
+
+
+def read_symbols(nm, elf):
+    """
+    Returns (name, size, address) for every sized symbol in the ELF, and the
+    set of all symbol names.
+    """
+    output = subprocess.run(
+        [nm, "-C", "-S", elf], check=True, capture_output=True, text=True
+    ).stdout.splitlines()
+
+    sized = []
+    names = set()
+    for line in output:
+        match = SYMBOL_PATTERN.match(line)
+        if match:
+            address, size, kind, name = match.groups()
+            if kind.lower() in "bdr":
+                sized.append((name, int(size, 16), int(address, 16)))
+            names.add(name)
+        else:
+            parts = line.split(None, 2)
+            if len(parts) >= 2:
+                names.add(parts[-1])
+    return sized, names
+
+
+def startup(sections):
+    """
+    Returns (copied, zeroed, constructors): bytes the reset handler copies
+    from flash and zeroes, and the number of static constructors it runs.
+    The NOLOAD regions (.dtcmram_bss, .sram1_bss, .sdram_bss) cost nothing.
+    """
+    copied = zeroed = constructors = 0
+    for name, size, vma, lma, flags in sections:
+        if "ALLOC" not in flags:
+            continue
+        if name == ".init_array":
+            constructors += size // 4
+        elif "LOAD" in flags and vma != lma:
+            copied += size
+        elif name == ".bss":
+            zeroed += size
+    return copied, zeroed, constructors
+
+
+def main():
+    args = parse_arguments()
+
+    reserve = dict(DEFAULT_RESERVE)
+    for item in args.reserve:
+        region, _, size = item.partition("=")
+        if region not in REGIONS:
+            sys.exit(f"Unknown region '{region}'")
+        reserve[region] = parse_size(size)
+
+    sections = read_sections(args.objdump, args.elf)
+    used, placement = tally(sections)
+
+    overflow = False
+    print(f"{'Region':<7}{'Used':>10}{'Reserved':>10}{'Size':>10}{'Use':>8}")
+    for name, (_, length) in REGIONS.items():
+        if used[name] == 0:
+            continue
+        budget = length - reserve.get(name, 0)
+        percent = 100.0 * used[name] / budget
+        status = ""
+        if used[name] > budget:
+            overflow = True
+            status = "  OVERFLOW"
+        print(
+            f"{name:<7}{used[name]:>10}{reserve.get(name, 0):>10}"
+            f"{length:>10}{percent:>7.1f}%{status}"
+        )
+        for section, size in sorted(placement[name], key=lambda s: -s[1]):
+            print(f"    {section:<24}{size:>10}")
+
+    copied, zeroed, constructors = startup(sections)
+    print(
+        f"Startup: {copied} bytes copied from flash, {zeroed} bytes zeroed, "
+        f"{constructors} static constructors"
+    )
+
+    symbols, names = read_symbols(args.nm, args.elf)
+    heap = [name for name in HEAP_SYMBOLS if name in names]
+    print("Heap: " + ("linked (" + ", ".join(heap) + ")" if heap else "not linked"))
+
+    if args.symbols > 0:
+        for name in REGIONS:
+            largest = sorted(
+                (s for s in symbols if region_of(s[2]) == name),
+                key=lambda s: -s[1],
+            )[: args.symbols]
+            if largest:
+                print(f"Largest in {name}:")
+                for symbol, size, _ in largest:
+                    print(f"    {symbol[:48]:<48}{size:>10}")
+
+    if overflow:
+        sys.exit("Memory budget exceeded.")
+
+
+if __name__ == "__main__":
+    main()
@@ -14,11 +14,19 @@
 #include "daisysp.h"
 #include "hothouse.h"
 #include "buzzbox_hothouse.h"
+#include "memory_placement.h"
 
 #include <q/support/literals.hpp>
 #include <q/fx/biquad.hpp>
 #include "Util/Multirate.h"
 #include "Util/OctaveGenerator.h"
+#include "Util/Version.h"
+#include "Util/Oversampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
 namespace q = cycfi::q;
 using namespace q::literals;
 
@@ -26,25 +34,51 @@ using namespace daisy;
 using namespace daisysp;
 using namespace clevelandmusicco;
 
+static_assert(OCTAVE_DSP_VERSION_MAJOR == 1, "written against OctaveDSP 1.x");
+
 // Hardware object
 Hothouse hw;
 
+// Samples per audio callback; AudioCallback() processes the chain in a
+// buffer of this size
+constexpr size_t audio_block_size = 256;
+
 // Audio processing objects
-Tone tone;
 Tone master_lowpass;  // 8kHz anti-aliasing filter
-Adsr autowah_adsr;
-Svf autowah_svf;
-ATone autowah_detector_hpf;  // High-pass filter for envelope detection (evens out frequency response)
-EnvelopeFollower envelopeFollower;
+AutoWah autowah;
+
+// Noise gate ahead of the fuzz and octave (override from the Makefile).
+// While it is closed for a whole block, the chain is skipped.
+#ifndef NOISE_GATE_DB
+#define NOISE_GATE_DB -60.0f  // opening threshold, dBFS at the input
+#endif
+NoiseGate noise_gate;
+bool chain_idle = false;  // the chain was skipped and reset on a closed block
 
 // Octave processing objects
-static Decimator2 decimate;
-static Interpolator interpolate;
 static const auto sample_rate_temp = 48000;
-static OctaveGenerator octave(sample_rate_temp / resample_factor);
-float octave_buff[6];
-float octave_buff_out[6];
-int octave_bin_counter = 0;
+// Octave band layout (override from the Makefile, see OctaveGenerator.h)
+#ifndef OCTAVE_BANDS
+#define OCTAVE_BANDS 80
+#endif
+#ifndef OCTAVE_LOW_HZ
+#define OCTAVE_LOW_HZ OctaveGenerator<>::default_low_hz
+#endif
+#ifndef OCTAVE_HIGH_HZ
+#define OCTAVE_HIGH_HZ OctaveGenerator<>::default_high_hz
+#endif
+#ifndef OCTAVE_SLEEP_LEVEL
+#define OCTAVE_SLEEP_LEVEL 0.0001f  // -80 dB; 0 processes every band every sample
+#endif
+#ifndef OCTAVE_QUALITY
+#define OCTAVE_QUALITY fast  // phase scaling kernel: reference, fast or high
+#endif
+// Memory region for the octave engine (see memory_placement.h)
+#ifndef BUZZBOX_OCTAVE_MEM
+#define BUZZBOX_OCTAVE_MEM DTCM
+#endif
+// The octave engine is built by its constructor, before hw.Init()
+static_assert(MEM_CONSTRUCTIBLE(BUZZBOX_OCTAVE_MEM), "BUZZBOX_OCTAVE_MEM: the octave engine can't go in SDRAM");
 
 // Control variables
 float knobValues[6] = {0.0f};
@@ -70,6 +104,55 @@ bool autowah_enabled = false;
 bool octave_enabled = false;
 int autowah_placement = 0; // 0=before fuzz, 1=after fuzz, 2=after everything
 
+// Knob 4-6 positions last applied by updateSwitch3(). It only runs again
+// when one moves by more than knob_epsilon, or Switch 3 changes.
+constexpr float knob_epsilon = 1.0f / 1024.0f;
+float applied_knobs[3] = {-1.0f, -1.0f, -1.0f};
+
+// The knob values the audio path actually uses, smoothed at block rate
+// towards the raw values above (see smoothParameters())
+SmoothedParameter input_gain_smooth, mix_smooth, level_smooth;
+SmoothedParameter drive_smooth, tone_smooth;
+SmoothedParameter octave_up_smooth, octave_down_smooth, octave_mix_smooth;
+float fuzz_gain = 1.0f;
+
+// Octave generation at the decimated rate. MultirateScheduler spreads the
+// band work evenly over the six samples of each low-rate period instead of
+// running it all on every sixth sample. The stage owns the generator, so
+// the whole octave engine is the one `multirate` object.
+struct OctaveStage
+{
+    OctaveGenerator<OCTAVE_BANDS> octave{sample_rate_temp / resample_factor,
+                                         OCTAVE_BANDS, OCTAVE_LOW_HZ, OCTAVE_HIGH_HZ};
+
+    void begin(float sample)
+    {
+        octave.begin(sample);
+    }
+
+    void step(std::size_t i)
+    {
+        octave.step(i, resample_factor);
+    }
+
+    float end()
+    {
+        octave.end();
+
+        // Mix up and down octaves with individual level controls
+        return octave.up1() * octave_up_smooth.Value() * 2.5f +
+               octave.down1() * octave_down_smooth.Value() * 2.5f;
+    }
+
+    void reset()
+    {
+        octave.reset();
+    }
+};
+// Its constructor sets every piece of state at startup, so it needs no
+// clearing in main() in a NOLOAD region (but can't go in SDRAM, see above)
+static MultirateScheduler<OctaveStage> MEM_PLACE(BUZZBOX_OCTAVE_MEM) multirate;
+
 // LEDs
 Led led1, led2;
 
@@ -136,18 +219,17 @@ void updateSwitch3() {
             // Knob 4: Attack/Release Speed (linked)
             if (knob_touched[3]) {
                 autowah_speed = knobValues[3];
-                float attack_time = 0.01f + (autowah_speed * 0.19f);   // 10ms to 200ms
-                float release_time = 0.02f + (autowah_speed * 0.38f);  // 20ms to 400ms
-                autowah_adsr.SetAttackTime(attack_time);
-                autowah_adsr.SetReleaseTime(release_time);
+                autowah.SetSpeed(autowah_speed);  // 10-200ms attack, 20-400ms release
             }
             // Knob 5: Filter Range (shifts base 300-2000Hz range)
             if (knob_touched[4]) {
                 autowah_range = knobValues[4];
+                autowah.SetRange(autowah_range);
             }
             // Knob 6: Threshold (trigger sensitivity)
             if (knob_touched[5]) {
                 autowah_threshold = knobValues[5];
+                autowah.SetThreshold(autowah_threshold);
             }
             break;
             
@@ -166,6 +248,39 @@ void updateSwitch3() {
             }
             break;
     }
+    
+    for (int i = 0; i < 3; i++) {
+        applied_knobs[i] = knobValues[3 + i];
+    }
+}
+
+bool contextKnobsMoved() {
+    for (int i = 0; i < 3; i++) {
+        if (std::abs(knobValues[3 + i] - applied_knobs[i]) > knob_epsilon) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Routing key bits: which of the switchable stages (2-6.5) run, and whether
+// the autowah comes after the fuzz. Placements MIDDLE and DOWN are the same
+// place in the chain (nothing runs between stages 5 and 6).
+enum RoutingBits : uint8_t {
+    ROUTE_FUZZ = 1,
+    ROUTE_AUTOWAH = 2,
+    ROUTE_OCTAVE = 4,
+    ROUTE_AUTOWAH_POST = 8,
+    ROUTE_COUNT = 16
+};
+
+uint8_t routingKey() {
+    uint8_t key = 0;
+    if (fuzz_enabled) key |= ROUTE_FUZZ;
+    if (autowah_enabled) key |= ROUTE_AUTOWAH;
+    if (octave_enabled) key |= ROUTE_OCTAVE;
+    if (autowah_placement != 0) key |= ROUTE_AUTOWAH_POST;
+    return key;
 }
 
 void UpdateLEDs() {
@@ -189,8 +304,10 @@ void ProcessControls() {
     
     // Detect knob movement for touch-to-activate behavior
     // Only check knobs 4-6 (context-dependent knobs)
+    bool newly_touched = false;
     for(int i = 3; i < 6; i++) {
         if (std::abs(knobValues[i] - prevKnobValues[i]) > 0.01f) {
+            newly_touched = newly_touched || !knob_touched[i];
             knob_touched[i] = true;  // Knob has moved
             prevKnobValues[i] = knobValues[i];  // Only update after detecting movement
         }
@@ -229,8 +346,12 @@ void ProcessControls() {
         updateSwitch3();
     }
     
-    // Update context-dependent parameters continuously
-    updateSwitch3();
+    // Update context-dependent parameters when knobs 4-6 move, or one has
+    // just been touched: a knob creeping past the 0.01 touch threshold may
+    // have moved less than knob_epsilon since the last update
+    if (newly_touched || contextKnobsMoved()) {
+        updateSwitch3();
+    }
     
     first_start = false;
     
@@ -262,258 +383,247 @@ void ProcessControls() {
     UpdateLEDs();
 }
 
-void AudioCallback(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size) {
-    ProcessControls();
-    
-    for (size_t i = 0; i < size; i++) {
-        float input = in[0][i];
-        float signal = input;
-        
-        // STAGE 1: Input Gain (Knob 1) - affects everything
-        const float input_gain = 0.5f + (knobValues[0] * 1.5f); // 0.5x to 2.0x
-        signal *= input_gain;
-        
-        // STAGE 2: Autowah BEFORE fuzz (if placement is UP and enabled)
-        if (autowah_enabled && autowah_placement == 0) {
-            // High-pass filter for envelope detection (removes bass dominance)
-            float detection_signal = autowah_detector_hpf.Process(signal);
-            float envelope = envelopeFollower.Process(detection_signal);
-            
-            // Gate ADSR based on envelope level and threshold (lowered for HPF compensation)
-            // When threshold is at 0, gate is always open (static filter at sustain level)
-            bool gate;
-            if (autowah_threshold > 0.01f) {
-                float gate_level = 0.01f + (autowah_threshold * 0.11f); // 0.01 to 0.12
-                gate = (envelope > gate_level);
+// STAGE 3: Octave processing
+inline float processOctave(float signal) {
+    float octave_signal = multirate(signal);
+
+    // Mix octave with dry based on octave_mix
+    const float mix = octave_mix_smooth.Value();
+    return signal * (1.0f - mix) + octave_signal * mix;
+}
+
+// STAGE 4: Fuzz - Always AGGRESSIVE type. One voice: it owns all of its
+// filter and gate state, so a second voice (dual or stereo fuzz) shares
+// nothing with it.
+struct FuzzStage
+{
+    Fuzz fuzz;
+    Oversampler oversampler{OVERSAMPLING_FACTOR};
+    Tone tone;
+    float bass_lpf = 0.0f;
+    float gate_envelope = 0.0f;
+
+    float process(float signal)
+    {
+        float fuzz_signal = signal;
+
+        // Bass boost
+        const float bass_coeff = 0.05f;
+        bass_lpf = bass_lpf + bass_coeff * (fuzz_signal - bass_lpf);
+        fuzz_signal = fuzz_signal + (bass_lpf * 0.8f);
+
+        // Drive control - combines gain and intensity (both set in smoothParameters())
+        fuzz_signal *= fuzz_gain;
+
+        // Fuzz at OVERSAMPLING_FACTOR times the sample rate
+        float oversampled[Oversampler::max_ratio];
+        oversampler.upsample(&fuzz_signal, 1, oversampled);
+        fuzz.Process(oversampled, oversampled, oversampler.ratio());
+        oversampler.downsample(oversampled, 1, &fuzz_signal);
+
+        // Gate control - variable threshold
+        if (gate_threshold > 0.01f) {
+            const float gate_level = gate_threshold * 0.1f; // Scale threshold
+            const float gate_attack = 0.95f;
+            const float gate_release = 0.01f;
+
+            float input_level = std::abs(signal); // Gate detects pre-fuzz level
+
+            if (input_level > gate_level) {
+                gate_envelope += gate_attack * (1.0f - gate_envelope);
             } else {
-                gate = true;  // Gate always open - static filter
+                gate_envelope += gate_release * (0.0f - gate_envelope);
             }
-            float adsr_out = autowah_adsr.Process(gate);
-            
-            // Map ADSR output to filter frequency with range control
-            // Base range: 300-2000Hz
-            // Range knob shifts this: CCW = 100-1100Hz, CW = 300-3000Hz
-            float range_min = 100.0f + (autowah_range * 200.0f);  // 100-300Hz
-            float range_max = 1100.0f + (autowah_range * 1900.0f); // 1100-3000Hz
-            
-            float filter_freq = range_min + (adsr_out * (range_max - range_min));
-            
-            autowah_svf.SetFreq(filter_freq);
-            autowah_svf.SetRes(0.7f);
-            
-            // Process through SVF and use bandpass output with gain compensation
-            autowah_svf.Process(signal);
-            signal = autowah_svf.Band() * 2.0f;  // Autowah makeup gain
+
+            fuzz_signal *= gate_envelope;
         }
+
+        // Tone control (cutoff set in smoothParameters())
+        fuzz_signal = tone.Process(fuzz_signal);
+
+        return fuzz_signal;
+    }
+
+    // Back to rest: clears the oversampler, fuzz, bass boost and gate
+    void reset()
+    {
+        oversampler.reset();
+        fuzz.Reset();
+        bass_lpf = 0.0f;
+        gate_envelope = 0.0f;
+    }
+};
+FuzzStage fuzz_stage;
+
+// The switchable stages for one routing, composed at compile time: the
+// disabled stages drop out and the rest are inlined into a single loop with
+// no per-sample branches.
+template <uint8_t Key>
+void processChain(float* signal, size_t size) {
+    constexpr bool fuzz_on = Key & ROUTE_FUZZ;
+    constexpr bool autowah_on = Key & ROUTE_AUTOWAH;
+    constexpr bool octave_on = Key & ROUTE_OCTAVE;
+    constexpr bool autowah_post = Key & ROUTE_AUTOWAH_POST;
+    
+    for (size_t i = 0; i < size; i++) {
+        float sample = signal[i];
         
-        // STAGE 3: Octave processing (if enabled)
-        if (octave_enabled) {
-            // Buffer input for octave processing
-            octave_buff[octave_bin_counter] = signal;
-            
-            // Process octave every 6 samples
-            if (octave_bin_counter == 5) {
-                std::span<const float, resample_factor> in_chunk(&(octave_buff[0]), resample_factor);
-                const auto sample = decimate(in_chunk);
-                
-                octave.update(sample);
-                
-                // Mix up and down octaves with individual level controls
-                float octave_signal = octave.up1() * octave_up_level * 2.5f + 
-                                     octave.down1() * octave_down_level * 2.5f;
-                
-                auto out_chunk = interpolate(octave_signal);
-                for (size_t j = 0; j < out_chunk.size(); ++j) {
-                    // Mix octave with dry based on octave_mix
-                    octave_buff_out[j] = octave_buff[j] * (1.0f - octave_mix) + 
-                                        out_chunk[j] * octave_mix;
-                }
-            }
-            
-            // Use octave-processed signal if available
-            if (octave_bin_counter < 6) {
-                signal = octave_buff_out[octave_bin_counter];
-            }
-            
-            // Update bin counter
-            octave_bin_counter++;
-            if (octave_bin_counter >= 6) {
-                octave_bin_counter = 0;
-            }
+        // STAGE 2: Autowah BEFORE fuzz (placement UP)
+        if constexpr (autowah_on && !autowah_post) {
+            sample = autowah.Process(sample);
         }
         
-        // STAGE 4: Fuzz (if enabled) - Always AGGRESSIVE type
-        if (fuzz_enabled) {
-            float fuzz_signal = signal;
-            
-            // Bass boost
-            static float bass_lpf = 0.0f;
-            const float bass_coeff = 0.05f;
-            bass_lpf = bass_lpf + bass_coeff * (fuzz_signal - bass_lpf);
-            fuzz_signal = fuzz_signal + (bass_lpf * 0.8f);
-            
-            // Drive control - combines gain and intensity
-            // Map 0-1 knob to gain (1-20x) and intensity (0-1) proportionally
-            const float gain = 1.0f + (drive_amount * 19.0f); // 1x to 20x
-            const float intensity = drive_amount; // 0 to 1
-            fuzz_signal *= gain;
-            
-            // Fuzz with oversampling - 4x for performance
-            std::vector<float> oversampled = Oversampling::upsample(fuzz_signal);
-            for (float& sample : oversampled) {
-                sample = Fuzz::process(sample, FuzzType::AGGRESSIVE, intensity);
-            }
-            fuzz_signal = Oversampling::downsample(oversampled);
-            
-            // Gate control - variable threshold
-            if (gate_threshold > 0.01f) {
-                static float gate_envelope = 0.0f;
-                const float gate_level = gate_threshold * 0.1f; // Scale threshold
-                const float gate_attack = 0.95f;
-                const float gate_release = 0.01f;
-                
-                float input_level = std::abs(signal); // Gate detects pre-fuzz level
-                
-                if (input_level > gate_level) {
-                    gate_envelope += gate_attack * (1.0f - gate_envelope);
-                } else {
-                    gate_envelope += gate_release * (0.0f - gate_envelope);
-                }
-                
-                fuzz_signal *= gate_envelope;
-            }
-            
-            // Tone control
-            tone.SetFreq(tone_freq);
-            fuzz_signal = tone.Process(fuzz_signal);
-            
-            signal = fuzz_signal;
+        // STAGE 3: Octave
+        if constexpr (octave_on) {
+            sample = processOctave(sample);
         }
         
-        // STAGE 5: Autowah AFTER fuzz (if placement is MIDDLE and enabled)
-        if (autowah_enabled && autowah_placement == 1) {
-            // High-pass filter for envelope detection (removes bass dominance)
-            float detection_signal = autowah_detector_hpf.Process(signal);
-            float envelope = envelopeFollower.Process(detection_signal);
-            
-            // Gate ADSR based on envelope level and threshold (lowered for HPF compensation)
-            // When threshold is at 0, gate is always open (static filter at sustain level)
-            bool gate;
-            if (autowah_threshold > 0.01f) {
-                float gate_level = 0.01f + (autowah_threshold * 0.11f); // 0.01 to 0.12
-                gate = (envelope > gate_level);
-            } else {
-                gate = true;  // Gate always open - static filter
-            }
-            float adsr_out = autowah_adsr.Process(gate);
-            
-            // Map ADSR output to filter frequency with range control
-            float range_min = 100.0f + (autowah_range * 200.0f);
-            float range_max = 1100.0f + (autowah_range * 1900.0f);
-            
-            float filter_freq = range_min + (adsr_out * (range_max - range_min));
-            
-            autowah_svf.SetFreq(filter_freq);
-            autowah_svf.SetRes(0.7f);
-            
-            // Process through SVF and use bandpass output with gain compensation
-            autowah_svf.Process(signal);
-            signal = autowah_svf.Band() * 2.0f;  // Autowah makeup gain
+        // STAGE 4: Fuzz
+        if constexpr (fuzz_on) {
+            sample = fuzz_stage.process(sample);
         }
         
-        // STAGE 6: Autowah AFTER everything (if placement is DOWN and enabled)
-        if (autowah_enabled && autowah_placement == 2) {
-            // High-pass filter for envelope detection (removes bass dominance)
-            float detection_signal = autowah_detector_hpf.Process(signal);
-            float envelope = envelopeFollower.Process(detection_signal);
-            
-            // Gate ADSR based on envelope level and threshold (lowered for HPF compensation)
-            // When threshold is at 0, gate is always open (static filter at sustain level)
-            bool gate;
-            if (autowah_threshold > 0.01f) {
-                float gate_level = 0.01f + (autowah_threshold * 0.11f); // 0.01 to 0.12
-                gate = (envelope > gate_level);
-            } else {
-                gate = true;  // Gate always open - static filter
-            }
-            float adsr_out = autowah_adsr.Process(gate);
-            
-            // Map ADSR output to filter frequency with range control
-            float range_min = 100.0f + (autowah_range * 200.0f);
-            float range_max = 1100.0f + (autowah_range * 1900.0f);
-            
-            float filter_freq = range_min + (adsr_out * (range_max - range_min));
-            
-            autowah_svf.SetFreq(filter_freq);
-            autowah_svf.SetRes(0.7f);
-            
-            // Process through SVF and use bandpass output with gain compensation
-            autowah_svf.Process(signal);
-            signal = autowah_svf.Band() * 2.0f;  // Autowah makeup gain
+        // STAGES 5 and 6: Autowah AFTER fuzz (MIDDLE) or after everything (DOWN)
+        if constexpr (autowah_on && autowah_post) {
+            sample = autowah.Process(sample);
         }
         
-        // STAGE 6.5: FS2 Makeup Gain
+        // STAGE 6.5: FS2 makeup gain
         // Compensate for volume loss from autowah bandpass and octave processing
         // Only apply when FS2 effects are active and fuzz is bypassed
-        if ((autowah_enabled || octave_enabled) && !fuzz_enabled) {
-            signal *= 2.0f;  // Makeup gain for FS2 effects
+        if constexpr ((autowah_on || octave_on) && !fuzz_on) {
+            sample *= 2.0f;
         }
         
+        signal[i] = sample;
+    }
+}
+
+// Runs the switchable stages over a block, in place
+using ChainFunction = void (*)(float* signal, size_t size);
+
+// The placement bit means nothing with the autowah off; dropping it there
+// keeps the table at 12 distinct chains instead of 16
+constexpr uint8_t canonicalRoutingKey(uint8_t key) {
+    return (key & ROUTE_AUTOWAH) ? key : (key & ~ROUTE_AUTOWAH_POST);
+}
+
+template <size_t... Keys>
+constexpr std::array<ChainFunction, sizeof...(Keys)> makeChainTable(std::index_sequence<Keys...>) {
+    return {&processChain<canonicalRoutingKey(Keys)>...};
+}
+
+// processChain() for every routing key
+constexpr auto chain_table = makeChainTable(std::make_index_sequence<ROUTE_COUNT>());
+
+// Moves every smoothed parameter one block towards its knob value. The fuzz
+// drive and tone cutoff are only recomputed when they have moved by more
+// than their epsilon, so ADC jitter on a knob at rest costs nothing.
+void smoothParameters() {
+    input_gain_smooth.Process(0.5f + (knobValues[0] * 1.5f)); // 0.5x to 2.0x
+    mix_smooth.Process(knobValues[1]);
+    level_smooth.Process(knobValues[2]);
+    octave_up_smooth.Process(octave_up_level);
+    octave_down_smooth.Process(octave_down_level);
+    octave_mix_smooth.Process(octave_mix);
+    
+    // Map 0-1 drive to gain (1-20x) and intensity (0-1) proportionally
+    if (drive_smooth.Process(drive_amount)) {
+        fuzz_gain = 1.0f + (drive_smooth.Value() * 19.0f); // 1x to 20x
+        fuzz_stage.fuzz.SetIntensity(drive_smooth.Value());
+    }
+    
+    if (tone_smooth.Process(tone_freq)) {
+        fuzz_stage.tone.SetFreq(tone_smooth.Value());
+    }
+}
+
+void AudioCallback(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size) {
+    ProcessControls();
+    smoothParameters();
+    
+    // STAGE 1: Noise gate (detecting on the raw input) and Input Gain
+    // (Knob 1) - affects everything. The gains ramp linearly across the
+    // block to their new smoothed values. The gate only applies while the
+    // fuzz or octave is on; with the autowah alone or no effects, quiet
+    // playing passes as it is. Its detector keeps running either way, so
+    // it is up to date when one of them is switched on.
+    assert(size <= audio_block_size);
+    const uint8_t routing = routingKey();
+    float signal[audio_block_size];
+    bool gate_closed = noise_gate.Process(in[0], signal, size);
+    if (!(routing & (ROUTE_FUZZ | ROUTE_OCTAVE))) {
+        std::fill(signal, signal + size, 1.0f);
+        gate_closed = false;
+    }
+    float input_gain = input_gain_smooth.Previous();
+    const float input_gain_step = input_gain_smooth.Step(size);
+    for (size_t i = 0; i < size; i++) {
+        input_gain += input_gain_step;
+        signal[i] *= in[0][i] * input_gain;
+    }
+    
+    // STAGES 2-6.5: the switchable effects, one table lookup per block
+    if (!gate_closed) {
+        chain_table[routing](signal, size);
+        chain_idle = false;
+    } else if (!chain_idle) {
+        // The chain input is silent, and its tails faded out with the gate
+        // release, so skip the fuzz stage and octave bands until the gate
+        // opens. They restart from rest rather than from stale state.
+        fuzz_stage.reset();
+        multirate.reset();
+        chain_idle = true;
+    }
+    
+    float mix = mix_smooth.Previous();
+    float level = level_smooth.Previous();
+    const float mix_step = mix_smooth.Step(size);
+    const float level_step = level_smooth.Step(size);
+    for (size_t i = 0; i < size; i++) {
+        const float input = in[0][i];
+        mix += mix_step;
+        level += level_step;
+        
         // STAGE 6.75: Master Anti-Aliasing Lowpass Filter
         // 8kHz lowpass removes all aliasing from octave/fuzz while preserving musical content
-        signal = master_lowpass.Process(signal);
+        float wet = master_lowpass.Process(signal[i]);
         
         // STAGE 7: Dry/Wet Mix (Knob 2)
-        const float mix = knobValues[1];
-        signal = input * (1.0f - mix) + signal * mix;
+        wet = input * (1.0f - mix) + wet * mix;
         
         // STAGE 8: Output Level (Knob 3)
-        const float level = knobValues[2];
-        signal *= level;
+        wet *= level;
         
-        out[0][i] = signal;
-        out[1][i] = signal;
+        out[0][i] = wet;
+        out[1][i] = wet;
     }
 }
 
 int main(void) {
     // CPU boost to 480MHz for better performance
     hw.Init(true);
-    hw.SetAudioBlockSize(256);  // Larger block size for efficiency
+    hw.SetAudioBlockSize(audio_block_size);  // Larger block size for efficiency
     
     float samplerate = hw.AudioSampleRate();
-    tone.Init(samplerate);
+    fuzz_stage.tone.Init(samplerate);
     
     // Initialize master lowpass for anti-aliasing at 8kHz
     master_lowpass.Init(samplerate);
     master_lowpass.SetFreq(8000.0f);
     
-    // Initialize ADSR for autowah envelope
-    autowah_adsr.Init(samplerate);
-    autowah_adsr.SetAttackTime(0.1f);
-    autowah_adsr.SetTime(ADSR_SEG_DECAY, 0.15f);
-    autowah_adsr.SetReleaseTime(0.2f);
-    autowah_adsr.SetSustainLevel(0.75f);  // 75% sustain for smooth transition
-    
-    // Initialize SVF for autowah filter
-    autowah_svf.Init(samplerate);
-    autowah_svf.SetFreq(800.0f);
-    autowah_svf.SetRes(0.7f);
-    
-    // Initialize high-pass filter for autowah envelope detection
-    // Removes bass frequencies to even out detection across frequency range
-    autowah_detector_hpf.Init(samplerate);
-    float detector_hpf_freq = 400.0f;  // Remove sub-400Hz from detection
-    autowah_detector_hpf.SetFreq(detector_hpf_freq);
-    
-    envelopeFollower.Init(samplerate, 5.0f, 50.0f); // Default medium sensitivity
-    
-    // Initialize octave buffers
-    for (int j = 0; j < 6; ++j) {
-        octave_buff[j] = 0.0f;
-        octave_buff_out[j] = 0.0f;
-    }
-    octave_bin_counter = 0;
+    // Autowah: 400Hz HPF on the detector, 5/50ms envelope, ADSR with 75% sustain
+    autowah.Init(samplerate);
+    
+    noise_gate.Init(samplerate);
+    noise_gate.SetThreshold(NOISE_GATE_DB);
+    
+    fuzz_stage.fuzz.Init(FuzzType::AGGRESSIVE);
+    fuzz_stage.fuzz.SetShaper(FuzzShaper::FUZZ_SHAPER);
+    fuzz_stage.fuzz.SetOversampling(OVERSAMPLING_FACTOR);
+    
+    multirate.stage().octave.setSleepThreshold(OCTAVE_SLEEP_LEVEL);
+    multirate.stage().octave.setQuality(ShifterQuality::OCTAVE_QUALITY);
     
     led1.Init(hw.seed.GetPin(Hothouse::LED_1), false);
     led2.Init(hw.seed.GetPin(Hothouse::LED_2), false);
@@ -541,6 +651,18 @@ int main(void) {
     octave_down_level = 0.5f;
     octave_mix = 0.5f;
     
+    // Smoothing time constants (ms) and the change below which a parameter
+    // is left alone: 1/1024 of the range, 1Hz for the tone cutoff
+    const float block_rate = samplerate / audio_block_size;
+    input_gain_smooth.Init(block_rate, 20.0f, knob_epsilon, 0.5f + (knobValues[0] * 1.5f));
+    mix_smooth.Init(block_rate, 20.0f, knob_epsilon, knobValues[1]);
+    level_smooth.Init(block_rate, 20.0f, knob_epsilon, knobValues[2]);
+    drive_smooth.Init(block_rate, 30.0f, knob_epsilon, drive_amount);
+    tone_smooth.Init(block_rate, 50.0f, 1.0f, tone_freq);
+    octave_up_smooth.Init(block_rate, 20.0f, knob_epsilon, octave_up_level);
+    octave_down_smooth.Init(block_rate, 20.0f, knob_epsilon, octave_down_level);
+    octave_mix_smooth.Init(block_rate, 20.0f, knob_epsilon, octave_mix);
+    
     fuzz_enabled = false;
     autowah_enabled = false;
     octave_enabled = false;
@@ -7,8 +7,10 @@
 #ifndef BUZZBOX_HOTHOUSE_H
 #define BUZZBOX_HOTHOUSE_H
 
-#include <vector>
+#include "daisysp.h"
+
 #include <cmath>
+#include <cstddef>
 #include <algorithm>
 
 // =============================================================================
@@ -21,12 +23,210 @@ enum class FuzzType {
     AGGRESSIVE = 2  // Asymmetric clip, more harmonics, pre-emphasis (default)
 };
 
-namespace Fuzz {
-    inline float softClipping(float input, float gain) {
+// Clipping curve for the fuzz stages
+enum class FuzzShaper {
+    TANH = 0,   // std::tanh; relies on oversampling against aliasing (default)
+    ADAA1 = 1,  // SoftClip with first-order antiderivative anti-aliasing
+    ADAA2 = 2   // SoftClip with second-order ADAA; less aliasing, more delay
+};
+
+// Tanh-like polynomial soft clipper, x - 2x^3/(3k^2) + x^5/(5k^4) up to the
+// knee k = 1.875 and +-1 beyond it, with a smooth (C2) transition. Its first
+// and second antiderivatives are polynomials too, which is what ADAA needs.
+// Positive outputs are scaled by `pos` (negative by 1), as the asymmetric
+// fuzz clip does.
+struct SoftClip {
+    static constexpr double knee = 1.875;
+    static constexpr double c3 = -2.0 / (3.0 * knee * knee);
+    static constexpr double c5 = 1.0 / (5.0 * knee * knee * knee * knee);
+    // Antiderivatives at the knee, to continue them past it
+    static constexpr double f1_knee = knee * knee / 2 + c3 * knee * knee * knee * knee / 4
+                                    + c5 * knee * knee * knee * knee * knee * knee / 6;
+    static constexpr double f2_knee = knee * knee * knee / 6 + c3 * knee * knee * knee * knee * knee / 20
+                                    + c5 * knee * knee * knee * knee * knee * knee * knee / 42;
+    
+    template <typename T>
+    static T f(T x, T pos) {
+        const T a = std::min(std::abs(x), T(knee));
+        const T a2 = a * a;
+        const T y = a * (T(1) + a2 * (T(c3) + a2 * T(c5)));
+        return (x > 0) ? y * pos : -y;
+    }
+    
+    // First antiderivative, F1' = f
+    template <typename T>
+    static T F1(T x, T pos) {
+        const T a = std::abs(x);
+        T y;
+        if (a < T(knee)) {
+            const T a2 = a * a;
+            y = a2 * (T(0.5) + a2 * (T(c3 / 4) + a2 * T(c5 / 6)));
+        } else {
+            y = a - T(knee) + T(f1_knee);
+        }
+        return (x > 0) ? y * pos : y;
+    }
+    
+    // Second antiderivative, F2' = F1
+    template <typename T>
+    static T F2(T x, T pos) {
+        const T a = std::abs(x);
+        T y;
+        if (a < T(knee)) {
+            const T a2 = a * a;
+            y = a * a2 * (T(1.0 / 6) + a2 * (T(c3 / 20) + a2 * T(c5 / 42)));
+        } else {
+            const T d = a - T(knee);
+            y = T(f2_knee) + d * (T(f1_knee) + d * T(0.5));
+        }
+        return (x > 0) ? y * pos : -y;
+    }
+};
+
+// SoftClip with antiderivative anti-aliasing (Parker, Zavalishin, Le Bihan
+// 2016): the output is the average of the curve over the line between the
+// last Order + 1 inputs, which works like a lowpass on the aliases. Costs
+// no transcendentals; order 1 delays the signal by half a sample, order 2 by
+// one. Order 2 works in double precision, as its differences of
+// differences lose too many bits in float.
+template <int Order>
+class AdaaClip {
+public:
+    static_assert(Order == 1 || Order == 2);
+    
+    void SetPositiveGain(float pos) { pos_ = pos; }
+    
+    void Reset() {
+        x1_ = 0;
+        x2_ = 0;
+        d1_ = 0;
+    }
+    
+    float Process(float x) {
+        if constexpr (Order == 1) {
+            const float x1 = static_cast<float>(x1_);
+            const float dx = x - x1;
+            const float y = (std::abs(dx) > 1e-4f)
+                ? (SoftClip::F1(x, pos_) - SoftClip::F1(x1, pos_)) / dx
+                : SoftClip::f(0.5f * (x + x1), pos_);
+            x1_ = x;
+            return y;
+        } else {
+            const double pos = pos_;
+            const double x0 = x;
+            const double d0 = diff(x0, x1_, pos);
+            double y;
+            const double dx = x0 - x2_;
+            if (std::abs(dx) > 1e-5) {
+                y = 2.0 * (d0 - d1_) / dx;
+            } else {
+                // Inputs x0 and x2 (nearly) equal: use their midpoint
+                const double mid = 0.5 * (x0 + x2_);
+                const double delta = mid - x1_;
+                y = (std::abs(delta) > 1e-5)
+                    ? 2.0 / delta * (SoftClip::F1(mid, pos) + (SoftClip::F2(x1_, pos) - SoftClip::F2(mid, pos)) / delta)
+                    : SoftClip::f(0.5 * (mid + x1_), pos);
+            }
+            x2_ = x1_;
+            x1_ = x0;
+            d1_ = d0;
+            return static_cast<float>(y);
+        }
+    }
+
+private:
+    // First divided difference of F2
+    static double diff(double a, double b, double pos) {
+        const double d = a - b;
+        return (std::abs(d) > 1e-5)
+            ? (SoftClip::F2(a, pos) - SoftClip::F2(b, pos)) / d
+            : SoftClip::F1(0.5 * (a + b), pos);
+    }
+    
+    float pos_ = 1.0f;
+    double x1_ = 0;
+    double x2_ = 0;
+    double d1_ = 0;  // diff(x1, x2)
+};
+
+// One fuzz voice. All of its filter and gate state is in the object, so
+// several can run side by side (dual or stereo fuzz), and the block form of
+// Process() keeps the state in registers for the whole block.
+class Fuzz {
+public:
+    // The filters were voiced with the fuzz running at 4x the sample rate
+    static constexpr size_t design_oversampling = 4;
+    
+    Fuzz() { Reset(); }
+    
+    void Init(FuzzType type = FuzzType::AGGRESSIVE) {
+        type_ = type;
+        Reset();
+    }
+    
+    void SetType(FuzzType type) { type_ = type; }
+    
+    void SetShaper(FuzzShaper shaper) {
+        shaper_ = shaper;
+        Reset();
+    }
+    
+    // Rate the fuzz runs at, as a multiple of the sample rate. The filter
+    // coefficients are rescaled so their corners stay where they are at
+    // design_oversampling, e.g. for ADAA at 1x or 2x.
+    void SetOversampling(size_t ratio) {
+        if (ratio == design_oversampling) {
+            emphasis_coeff_ = 0.7f;
+            dc_coeff_ = 0.997f;
+            de_emphasis_coeff_ = 0.3f;
+            gate_attack_ = 0.95f;
+            gate_release_ = 0.01f;
+            return;
+        }
+        const float scale = static_cast<float>(design_oversampling) / ratio;
+        // Pre-emphasis is x + a * (x - x[n-1]), a differentiator: a scales with the rate
+        emphasis_coeff_ = 0.7f / scale;
+        dc_coeff_ = std::pow(0.997f, scale);
+        de_emphasis_coeff_ = 1.0f - std::pow(1.0f - 0.3f, scale);
+        gate_attack_ = 1.0f - std::pow(1.0f - 0.95f, scale);
+        gate_release_ = 1.0f - std::pow(1.0f - 0.01f, scale);
+    }
+    
+    // Intensity 0 to 1 (the drive knob); scaled once here rather than per sample
+    void SetIntensity(float intensity) { intensity_ = intensity * 10.0f; }
+    
+    float Process(float input) {
+        float out;
+        Process(&input, &out, 1);
+        return out;
+    }
+    
+    // Block form; `out` may be `in`
+    void Process(const float* in, float* out, size_t count) {
+        switch (shaper_) {
+            case FuzzShaper::TANH: process<FuzzShaper::TANH>(in, out, count); break;
+            case FuzzShaper::ADAA1: process<FuzzShaper::ADAA1>(in, out, count); break;
+            case FuzzShaper::ADAA2: process<FuzzShaper::ADAA2>(in, out, count); break;
+        }
+    }
+    
+    void Reset() {
+        pre_emphasis_state_ = 0.0f;
+        dc_blocker_x1_ = 0.0f;
+        dc_blocker_y1_ = 0.0f;
+        de_emphasis_state_ = 0.0f;
+        gate_envelope_ = 0.0f;
+        adaa1_[0].Reset();
+        adaa1_[1].Reset();
+        adaa2_[0].Reset();
+        adaa2_[1].Reset();
+    }
+    
+    static float softClipping(float input, float gain) {
         return std::tanh(input * gain);
     }
     
-    inline float asymmetricClip(float input, float intensity) {
+    static float asymmetricClip(float input, float intensity) {
         const float pos_threshold = 0.8f;
         const float neg_threshold = 1.0f;
         
@@ -36,76 +236,117 @@ namespace Fuzz {
             return softClipping(input, intensity) * neg_threshold;
         }
     }
+
+private:
+    // Internal gate for non-AGGRESSIVE types (the pedal's gate is Knob 6)
+    static constexpr float gate_threshold = 0.03f;
     
-    inline float fuzzEffect(float input, float intensity, FuzzType type) {
-        static float dc_blocker_x1 = 0.0f;
-        static float dc_blocker_y1 = 0.0f;
-        static float gate_envelope = 0.0f;
-        static float pre_emphasis_state = 0.0f;
+    template <FuzzShaper Shaper>
+    void process(const float* in, float* out, size_t count) {
+        // The first clip is asymmetric for AGGRESSIVE only
+        const float pos = (type_ == FuzzType::AGGRESSIVE) ? 0.8f : 1.0f;
+        adaa1_[0].SetPositiveGain(pos);
+        adaa2_[0].SetPositiveGain(pos);
         
-        float fuzzed = input;
-        
-        if (type == FuzzType::AGGRESSIVE) {
-            const float emphasis_coeff = 0.7f;
-            float pre_emphasized = input + (input - pre_emphasis_state) * emphasis_coeff;
-            pre_emphasis_state = input;
-            fuzzed = pre_emphasized;
+        switch (type_) {
+            case FuzzType::CLEAN: processBlock<FuzzType::CLEAN, Shaper>(in, out, count); break;
+            case FuzzType::GATED: processBlock<FuzzType::GATED, Shaper>(in, out, count); break;
+            case FuzzType::AGGRESSIVE: processBlock<FuzzType::AGGRESSIVE, Shaper>(in, out, count); break;
         }
-        
-        if (type == FuzzType::AGGRESSIVE) {
-            fuzzed = asymmetricClip(fuzzed, intensity);
-        } else {
-            fuzzed = softClipping(fuzzed, intensity);
-        }
-        
-        if (type == FuzzType::AGGRESSIVE) {
-            fuzzed += 0.03f * (input * input);
-            fuzzed += 0.012f * (input * input * input * input);
-            fuzzed += 0.015f * (input * input * input);
+    }
+    
+    // Clip stage 0 (the first, asymmetric for AGGRESSIVE) or 1
+    template <FuzzType Type, FuzzShaper Shaper, int Stage>
+    float clip(float x, float gain) {
+        if constexpr (Shaper == FuzzShaper::ADAA1) {
+            return adaa1_[Stage].Process(x * gain);
+        } else if constexpr (Shaper == FuzzShaper::ADAA2) {
+            return adaa2_[Stage].Process(x * gain);
+        } else if constexpr (Stage == 0 && Type == FuzzType::AGGRESSIVE) {
+            return asymmetricClip(x, gain);
         } else {
-            fuzzed += 0.02f * (input * input) + 0.008f * (input * input * input * input);
-        }
-        
-        const float dynamicIntensity = intensity * (1.0f + 0.5f * std::abs(input));
-        fuzzed = softClipping(fuzzed, dynamicIntensity);
-        
-        const float dc_coeff = 0.997f;
-        float dc_blocked = fuzzed - dc_blocker_x1 + dc_coeff * dc_blocker_y1;
-        dc_blocker_x1 = fuzzed;
-        dc_blocker_y1 = dc_blocked;
-        
-        if (type == FuzzType::AGGRESSIVE) {
-            static float de_emphasis_state = 0.0f;
-            const float de_emphasis_coeff = 0.3f;
-            de_emphasis_state = de_emphasis_state + de_emphasis_coeff * (dc_blocked - de_emphasis_state);
-            dc_blocked = de_emphasis_state;
+            return softClipping(x, gain);
         }
+    }
+    
+    template <FuzzType Type, FuzzShaper Shaper>
+    void processBlock(const float* in, float* out, size_t count) {
+        const float intensity = intensity_;
+        const float emphasis_coeff = emphasis_coeff_;
+        const float dc_coeff = dc_coeff_;
+        const float de_emphasis_coeff = de_emphasis_coeff_;
+        const float gate_attack = gate_attack_;
+        const float gate_release = gate_release_;
+        float pre_emphasis_state = pre_emphasis_state_;
+        float dc_blocker_x1 = dc_blocker_x1_;
+        float dc_blocker_y1 = dc_blocker_y1_;
+        float de_emphasis_state = de_emphasis_state_;
+        float gate_envelope = gate_envelope_;
         
-        if (type == FuzzType::CLEAN) {
-            return dc_blocked;
-        } else {
-            // Note: Gate is now controlled externally via Knob 6
-            // This internal gate is kept for non-AGGRESSIVE types
-            const float gate_threshold = 0.03f;
-            const float gate_attack = 0.95f;
-            const float gate_release = 0.01f;
-            
-            float input_level = std::abs(input);
+        for (size_t i = 0; i < count; ++i) {
+            const float input = in[i];
+            float fuzzed;
             
-            if (input_level > gate_threshold) {
-                gate_envelope += gate_attack * (1.0f - gate_envelope);
+            if constexpr (Type == FuzzType::AGGRESSIVE) {
+                float pre_emphasized = input + (input - pre_emphasis_state) * emphasis_coeff;
+                pre_emphasis_state = input;
+                fuzzed = clip<Type, Shaper, 0>(pre_emphasized, intensity);
+                
+                fuzzed += 0.03f * (input * input);
+                fuzzed += 0.012f * (input * input * input * input);
+                fuzzed += 0.015f * (input * input * input);
             } else {
-                gate_envelope += gate_release * (0.0f - gate_envelope);
+                fuzzed = clip<Type, Shaper, 0>(input, intensity);
+                fuzzed += 0.02f * (input * input) + 0.008f * (input * input * input * input);
             }
             
-            return dc_blocked * gate_envelope;
+            const float dynamicIntensity = intensity * (1.0f + 0.5f * std::abs(input));
+            fuzzed = clip<Type, Shaper, 1>(fuzzed, dynamicIntensity);
+            
+            float dc_blocked = fuzzed - dc_blocker_x1 + dc_coeff * dc_blocker_y1;
+            dc_blocker_x1 = fuzzed;
+            dc_blocker_y1 = dc_blocked;
+            
+            if constexpr (Type == FuzzType::AGGRESSIVE) {
+                de_emphasis_state = de_emphasis_state + de_emphasis_coeff * (dc_blocked - de_emphasis_state);
+                dc_blocked = de_emphasis_state;
+            }
+            
+            if constexpr (Type == FuzzType::CLEAN) {
+                out[i] = dc_blocked;
+            } else {
+                if (std::abs(input) > gate_threshold) {
+                    gate_envelope += gate_attack * (1.0f - gate_envelope);
+                } else {
+                    gate_envelope += gate_release * (0.0f - gate_envelope);
+                }
+                out[i] = dc_blocked * gate_envelope;
+            }
         }
+        
+        pre_emphasis_state_ = pre_emphasis_state;
+        dc_blocker_x1_ = dc_blocker_x1;
+        dc_blocker_y1_ = dc_blocker_y1;
+        de_emphasis_state_ = de_emphasis_state;
+        gate_envelope_ = gate_envelope;
     }
     
-    inline float process(float sample, FuzzType type, float intensity) {
-        return fuzzEffect(sample, intensity * 10.0f, type);
-    }
-}
+    FuzzType type_ = FuzzType::AGGRESSIVE;
+    FuzzShaper shaper_ = FuzzShaper::TANH;
+    float intensity_ = 0.0f;
+    float emphasis_coeff_ = 0.7f;
+    float dc_coeff_ = 0.997f;
+    float de_emphasis_coeff_ = 0.3f;
+    float gate_attack_ = 0.95f;
+    float gate_release_ = 0.01f;
+    float pre_emphasis_state_;
+    float dc_blocker_x1_;
+    float dc_blocker_y1_;
+    float de_emphasis_state_;
+    float gate_envelope_;
+    AdaaClip<1> adaa1_[2];
+    AdaaClip<2> adaa2_[2];
+};
 
 // =============================================================================
 // ENVELOPE FOLLOWER
@@ -113,38 +354,392 @@ namespace Fuzz {
 
 class EnvelopeFollower {
 public:
+    // PEAK follows |x|. RMS follows x^2 with the same ballistics and returns
+    // its square root; with equal attack and release times that is a running
+    // RMS level.
+    enum class Mode { PEAK, RMS };
+    
     EnvelopeFollower() : envelope_level_(0.0f) {}
     
     void Init(float samplerate, float attack_ms, float release_ms) {
         samplerate_ = samplerate;
+        attack_ms_ = -1.0f;  // force the coefficients to be computed
         setAttackRelease(attack_ms, release_ms);
     }
     
+    // Only recomputes the coefficients when a time changes, so it can be
+    // called with the knob values every block
     void setAttackRelease(float attack_ms, float release_ms) {
+        if (attack_ms == attack_ms_ && release_ms == release_ms_) {
+            return;
+        }
+        attack_ms_ = attack_ms;
+        release_ms_ = release_ms;
         attack_coeff_ = 1.0f - std::exp(-1.0f / (attack_ms * samplerate_ / 1000.0f));
         release_coeff_ = 1.0f - std::exp(-1.0f / (release_ms * samplerate_ / 1000.0f));
     }
     
+    void SetMode(Mode mode) {
+        if (mode != mode_) {
+            mode_ = mode;
+            // The state is a level in PEAK mode and a level squared in RMS mode
+            state_ = (mode == Mode::RMS) ? state_ * state_ : std::sqrt(state_);
+        }
+    }
+    
     float Process(float input) {
-        float input_level = std::abs(input);
-        
-        if (input_level > envelope_level_) {
-            envelope_level_ += attack_coeff_ * (input_level - envelope_level_);
+        if (mode_ == Mode::PEAK) {
+            return processSample<Mode::PEAK>(input);
+        }
+        return processSample<Mode::RMS>(input);
+    }
+    
+    // Block forms. The first writes the envelope for every sample to `out`
+    // (which may be `in`); the second only returns the envelope at the end
+    // of the block, for effects that update once per block.
+    void Process(const float* in, float* out, size_t count) {
+        if (mode_ == Mode::PEAK) {
+            processBlock<Mode::PEAK>(in, out, count);
         } else {
-            envelope_level_ += release_coeff_ * (input_level - envelope_level_);
+            processBlock<Mode::RMS>(in, out, count);
+        }
+    }
+    
+    float Process(const float* in, size_t count) {
+        if (mode_ == Mode::PEAK) {
+            processBlock<Mode::PEAK>(in, nullptr, count);
+        } else {
+            processBlock<Mode::RMS>(in, nullptr, count);
         }
-        
         return envelope_level_;
     }
     
     float GetEnvelopeLevel() const { return envelope_level_; }
-    void Reset() { envelope_level_ = 0.0f; }
+    void Reset() {
+        envelope_level_ = 0.0f;
+        state_ = 0.0f;
+    }
 
 private:
+    template <Mode M>
+    float processSample(float input) {
+        const float input_level = (M == Mode::PEAK) ? std::abs(input) : input * input;
+        
+        if (input_level > state_) {
+            state_ += attack_coeff_ * (input_level - state_);
+        } else {
+            state_ += release_coeff_ * (input_level - state_);
+        }
+        
+        envelope_level_ = (M == Mode::PEAK) ? state_ : std::sqrt(state_);
+        return envelope_level_;
+    }
+    
+    template <Mode M>
+    void processBlock(const float* in, float* out, size_t count) {
+        const float attack = attack_coeff_;
+        const float release = release_coeff_;
+        float state = state_;
+        
+        for (size_t i = 0; i < count; ++i) {
+            const float input_level = (M == Mode::PEAK) ? std::abs(in[i]) : in[i] * in[i];
+            state += ((input_level > state) ? attack : release) * (input_level - state);
+            if (out) {
+                out[i] = (M == Mode::PEAK) ? state : std::sqrt(state);
+            }
+        }
+        
+        state_ = state;
+        envelope_level_ = (M == Mode::PEAK) ? state : std::sqrt(state);
+    }
+    
     float samplerate_;
     float envelope_level_;
+    float state_ = 0.0f;
     float attack_coeff_;
     float release_coeff_;
+    float attack_ms_ = -1.0f;
+    float release_ms_ = -1.0f;
+    Mode mode_ = Mode::PEAK;
+};
+
+// =============================================================================
+// AUTOWAH
+// =============================================================================
+
+// Envelope-triggered band-pass wah, shared by the three placements (Switch 1).
+// The detector, envelope and ADSR run every sample. The filter cutoff is only
+// worked out every control_interval samples, and its coefficient ramps
+// linearly to each new value over the following interval, so the sinf behind
+// it runs once per control point instead of every sample. The filter is a
+// double-sampled Chamberlin SVF like daisysp::Svf, which takes a coefficient
+// rather than a frequency.
+class AutoWah {
+public:
+    static constexpr size_t control_interval = 16;
+    
+    void Init(float samplerate) {
+        samplerate_ = samplerate;
+        
+        adsr_.Init(samplerate);
+        adsr_.SetAttackTime(0.1f);
+        adsr_.SetTime(daisysp::ADSR_SEG_DECAY, 0.15f);
+        adsr_.SetReleaseTime(0.2f);
+        adsr_.SetSustainLevel(0.75f);  // 75% sustain for smooth transition
+        
+        // Removes bass frequencies to even out detection across frequency range
+        float detector_hpf_freq = 400.0f;  // ATone::SetFreq takes a reference
+        detector_hpf_.Init(samplerate);
+        detector_hpf_.SetFreq(detector_hpf_freq);
+        
+        envelope_.Init(samplerate, 5.0f, 50.0f);
+        
+        // Resonance 0.7, as daisysp::Svf::SetRes
+        damp_res_ = 2.0f * (1.0f - std::pow(resonance, 0.25f));
+        drive_ = 0.5f * resonance;
+        
+        SetRange(0.5f);
+        SetThreshold(0.1f);
+        Reset();
+    }
+    
+    // Attack/release speed 0 to 1: attack 10-200ms, release 20-400ms
+    void SetSpeed(float speed) {
+        adsr_.SetAttackTime(0.01f + (speed * 0.19f));
+        adsr_.SetReleaseTime(0.02f + (speed * 0.38f));
+    }
+    
+    // Filter range 0 to 1: CCW sweeps 100-1100Hz, CW 300-3000Hz
+    void SetRange(float range) {
+        range_min_ = 100.0f + (range * 200.0f);
+        range_max_ = 1100.0f + (range * 1900.0f);
+    }
+    
+    // Trigger threshold 0 to 1; 0 keeps the gate open (static resonant filter)
+    void SetThreshold(float threshold) {
+        gate_open_ = !(threshold > 0.01f);
+        gate_level_ = 0.01f + (threshold * 0.11f);  // 0.01 to 0.12
+    }
+    
+    void Reset() {
+        low_ = 0.0f;
+        band_ = 0.0f;
+        countdown_ = 0;
+        freq_step_ = 0.0f;
+        freq_ = coefficient(range_min_);
+        damp_ = std::min(damp_res_, 2.0f / freq_ - freq_ * 0.5f);
+    }
+    
+    float Process(float input) {
+        // High-pass filtered detection removes bass dominance
+        const float envelope = envelope_.Process(detector_hpf_.Process(input));
+        const float adsr_out = adsr_.Process(gate_open_ || envelope > gate_level_);
+        
+        if (countdown_ == 0) {
+            countdown_ = control_interval;
+            const float target = coefficient(range_min_ + (adsr_out * (range_max_ - range_min_)));
+            freq_step_ = (target - freq_) * (1.0f / control_interval);
+            damp_ = std::min(damp_res_, 2.0f / target - target * 0.5f);
+        }
+        --countdown_;
+        freq_ += freq_step_;
+        
+        // Two passes per sample, band-pass output averaged
+        float band_out = 0.0f;
+        for (int pass = 0; pass < 2; ++pass) {
+            const float notch = input - damp_ * band_;
+            low_ = low_ + freq_ * band_;
+            const float high = notch - low_;
+            band_ = freq_ * high + band_ - drive_ * band_ * band_ * band_;
+            band_out += 0.5f * band_;
+        }
+        
+        return band_out * 2.0f;  // Autowah makeup gain
+    }
+
+private:
+    static constexpr float resonance = 0.7f;
+    
+    // SVF frequency coefficient for the oversampled (2x) filter
+    float coefficient(float freq) const {
+        return 2.0f * std::sin(static_cast<float>(M_PI) * std::min(0.25f, freq / (samplerate_ * 2.0f)));
+    }
+    
+    daisysp::ATone detector_hpf_;
+    EnvelopeFollower envelope_;
+    daisysp::Adsr adsr_;
+    
+    float samplerate_ = 48000.0f;
+    float range_min_ = 200.0f;
+    float range_max_ = 2050.0f;
+    float gate_level_ = 0.021f;
+    bool gate_open_ = false;
+    
+    float damp_res_ = 0.0f;
+    float drive_ = 0.0f;
+    float freq_ = 0.0f;
+    float freq_step_ = 0.0f;
+    float damp_ = 0.0f;
+    size_t countdown_ = 0;
+    float low_ = 0.0f;
+    float band_ = 0.0f;
+};
+
+// =============================================================================
+// NOISE GATE
+// =============================================================================
+
+// Hysteretic gate with hold and release, for the front of the chain. It
+// opens when the input envelope rises above the threshold and closes once
+// the envelope has stayed 6dB below that for the hold time; the gain then
+// ramps down to exactly 0 over the release time. It opens in 1ms, so picking
+// attacks get through.
+class NoiseGate {
+public:
+    void Init(float samplerate) {
+        samplerate_ = samplerate;
+        envelope_.Init(samplerate, 0.5f, 20.0f);
+        attack_step_ = 1.0f / (0.001f * samplerate);
+        SetThreshold(-60.0f);
+        SetHold(50.0f);
+        SetRelease(100.0f);
+        Reset();
+    }
+    
+    // Opening threshold in dBFS; the gate closes 6dB below it
+    void SetThreshold(float db) {
+        open_level_ = std::pow(10.0f, db / 20.0f);
+        close_level_ = open_level_ * 0.5f;
+    }
+    
+    void SetHold(float ms) {
+        hold_samples_ = static_cast<size_t>(ms * 0.001f * samplerate_);
+    }
+    
+    void SetRelease(float ms) {
+        release_step_ = 1.0f / std::max(1.0f, ms * 0.001f * samplerate_);
+    }
+    
+    void Reset() {
+        envelope_.Reset();
+        open_ = false;
+        hold_ = 0;
+        gain_ = 0.0f;
+    }
+    
+    // Gain (0 to 1) for one input sample
+    float Process(float input) {
+        const float envelope = envelope_.Process(input);
+        
+        if (envelope > open_level_ || (open_ && envelope > close_level_)) {
+            open_ = true;
+            hold_ = hold_samples_;
+        } else if (hold_ > 0) {
+            --hold_;
+        } else {
+            open_ = false;
+        }
+        
+        gain_ = open_ ? std::min(gain_ + attack_step_, 1.0f)
+                      : std::max(gain_ - release_step_, 0.0f);
+        return gain_;
+    }
+    
+    // Block form: writes the gain for each sample of `in` to `gain`. Returns
+    // true when the gate was fully closed (gain 0) for the whole block, so
+    // the caller can skip processing silence.
+    bool Process(const float* in, float* gain, size_t count) {
+        bool closed = true;
+        for (size_t i = 0; i < count; ++i) {
+            gain[i] = Process(in[i]);
+            closed = closed && gain[i] == 0.0f;
+        }
+        return closed;
+    }
+    
+    bool IsOpen() const { return open_; }
+
+private:
+    EnvelopeFollower envelope_;
+    
+    float samplerate_ = 48000.0f;
+    float open_level_ = 0.001f;
+    float close_level_ = 0.0005f;
+    float attack_step_ = 0.0f;
+    float release_step_ = 0.0f;
+    size_t hold_samples_ = 0;
+    
+    bool open_ = false;
+    size_t hold_ = 0;
+    float gain_ = 0.0f;
+};
+
+// =============================================================================
+// PARAMETER SMOOTHING
+// =============================================================================
+
+// A knob-driven parameter, smoothed once per audio block. Each Process()
+// moves the value one one-pole step towards the target, with the time
+// constant set per parameter, and lands exactly on it once within `epsilon`.
+// A resting value ignores targets within `epsilon`, so ADC jitter on a
+// still knob leaves it alone. Per-sample users ramp from Previous() to
+// Value() across the block with Step(); users that derive coefficients
+// recompute them only when Process() returns true.
+class SmoothedParameter {
+public:
+    void Init(float block_rate, float time_ms, float epsilon, float value) {
+        coeff_ = 1.0f - std::exp(-1000.0f / (time_ms * block_rate));
+        epsilon_ = epsilon;
+        Reset(value);
+    }
+    
+    // Jumps straight to `value`; the next Process() reports a change
+    void Reset(float value) {
+        value_ = value;
+        previous_ = value;
+        applied_ = value;
+        moving_ = false;
+        pending_ = true;
+    }
+    
+    // Advances one block towards `target`. Returns true when the value has
+    // moved by more than epsilon since the last time it returned true, or
+    // has just settled on the target.
+    bool Process(float target) {
+        previous_ = value_;
+        const float delta = target - value_;
+        if (std::abs(delta) > epsilon_) {
+            value_ += coeff_ * delta;
+            moving_ = true;
+        } else if (moving_) {
+            value_ = target;
+            moving_ = false;
+            pending_ = true;
+        }
+        
+        if (pending_ || std::abs(value_ - applied_) > epsilon_) {
+            applied_ = value_;
+            pending_ = false;
+            return true;
+        }
+        return false;
+    }
+    
+    float Value() const { return value_; }
+    float Previous() const { return previous_; }
+    
+    // Per-sample increment of the linear ramp from Previous() to Value()
+    // over a block of `count` samples
+    float Step(size_t count) const { return (value_ - previous_) / count; }
+
+private:
+    float coeff_ = 1.0f;
+    float epsilon_ = 0.0f;
+    float value_ = 0.0f;
+    float previous_ = 0.0f;
+    float applied_ = 0.0f;
+    bool moving_ = false;
+    bool pending_ = true;
 };
 
 // =============================================================================
@@ -153,13 +748,24 @@ private:
 
 class AntiAliasingFilter {
 public:
-    AntiAliasingFilter() : x1_(0.0f), y1_(0.0f), coeff_(0.0f) {}
+    AntiAliasingFilter() : coeff_(0.0f), y1_(0.0f) {}
     
     void Init(float samplerate, float cutoff_freq) {
+        samplerate_ = samplerate;
+        cutoff_freq_ = -1.0f;  // force the coefficient to be computed
+        SetFreq(cutoff_freq);
+    }
+    
+    // Only recomputes the coefficient when the cutoff changes
+    void SetFreq(float cutoff_freq) {
+        if (cutoff_freq == cutoff_freq_) {
+            return;
+        }
+        cutoff_freq_ = cutoff_freq;
         // Simple one-pole lowpass: y[n] = a * x[n] + (1-a) * y[n-1]
         // cutoff = samplerate / (2 * pi * RC), solve for coefficient
         float rc = 1.0f / (2.0f * M_PI * cutoff_freq);
-        float dt = 1.0f / samplerate;
+        float dt = 1.0f / samplerate_;
         coeff_ = dt / (rc + dt);
     }
     
@@ -169,41 +775,42 @@ public:
         return y1_;
     }
     
+    // Block form; `out` may be `in`
+    void Process(const float* in, float* out, size_t count) {
+        const float a = coeff_;
+        const float b = 1.0f - coeff_;
+        float y = y1_;
+        for (size_t i = 0; i < count; ++i) {
+            y = a * in[i] + b * y;
+            out[i] = y;
+        }
+        y1_ = y;
+    }
+    
     void Reset() {
-        x1_ = 0.0f;
         y1_ = 0.0f;
     }
 
 private:
     float coeff_;
-    float x1_;
     float y1_;
+    float samplerate_ = 48000.0f;
+    float cutoff_freq_ = -1.0f;
 };
 
 // =============================================================================
-// OVERSAMPLING SYSTEM - Reduced to 4x for Performance
+// OVERSAMPLING - 4x by default, see Util/Oversampler.h
 // =============================================================================
 
-constexpr int OVERSAMPLING_FACTOR = 4;
+#ifndef FUZZ_OVERSAMPLING
+#define FUZZ_OVERSAMPLING 4  // 1, 2, 4 or 8
+#endif
 
-namespace Oversampling {
-    inline std::vector<float> upsample(float input) {
-        std::vector<float> output(OVERSAMPLING_FACTOR, 0.0f);
-        output[0] = input;
-        for (int i = 1; i < OVERSAMPLING_FACTOR; ++i) {
-            output[i] = input * (1.0f - static_cast<float>(i) / OVERSAMPLING_FACTOR);
-        }
-        return output;
-    }
-    
-    inline float downsample(const std::vector<float>& input) {
-        float sum = 0.0f;
-        for (float sample : input) {
-            sum += sample;
-        }
-        return sum / input.size();
-    }
-}
+constexpr int OVERSAMPLING_FACTOR = FUZZ_OVERSAMPLING;
+
+#ifndef FUZZ_SHAPER
+#define FUZZ_SHAPER TANH  // TANH, ADAA1 or ADAA2, see FuzzShaper
+#endif
 
 // =============================================================================
 // PARAMETER RANGES
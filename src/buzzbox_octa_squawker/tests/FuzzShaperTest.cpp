@@ -0,0 +1,186 @@
+// The fuzz's ADAA shapers against tanh: SoftClip's antiderivatives, and the
+// aliasing of the whole fuzz with its oversampler for 1-5 kHz tones, at the
+// ratios BUILD_INSTRUCTIONS.md suggests for each shaper
+//
+// Aliasing is the power below 20 kHz that isn't a harmonic of the tone,
+// relative to the power that is, from a Hann-windowed FFT.
+
+#include "Test.h"
+
+#include "buzzbox_hothouse.h"
+#include "Util/Oversampler.h"
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <vector>
+
+namespace
+{
+    constexpr double sample_rate = 48000;
+    constexpr float drive = 0.7f;
+    constexpr float amplitude = 0.3f;  // before the fuzz stage's gain
+    constexpr std::size_t block = 48;
+    constexpr std::array<float, 9> tones{1009, 1511, 2003, 2503, 3001, 3511, 4001, 4507, 4999};
+
+    struct Setting
+    {
+        const char* name;
+        FuzzShaper shaper;
+        std::size_t ratio;
+    };
+
+    struct Aliasing
+    {
+        double worst = -300;
+        double mean = 0;
+    };
+
+    // F1' = f and F2' = F1, by central differences over the curve, its knee
+    // and the flat part past it. With pos != 1, f has a kink at 0, where the
+    // difference is off by up to (1 - pos) h / 4.
+    void antiderivatives()
+    {
+        double f1 = 0, f2 = 0;
+        for (double x = -3; x <= 3; x += 0.001)
+        {
+            for (const double pos : {1.0, 0.8})
+            {
+                const double h = 1e-4;
+                const double d1 = (SoftClip::F1(x + h, pos) - SoftClip::F1(x - h, pos)) / (2 * h);
+                const double d2 = (SoftClip::F2(x + h, pos) - SoftClip::F2(x - h, pos)) / (2 * h);
+                f1 = std::max(f1, std::fabs(d1 - SoftClip::f(x, pos)));
+                f2 = std::max(f2, std::fabs(d2 - SoftClip::F1(x, pos)));
+            }
+        }
+        test::check(f1 < 1e-5, "SoftClip::F1' == f: worst error %.1e", f1);
+        test::check(f2 < 1e-6, "SoftClip::F2' == F1: worst error %.1e", f2);
+    }
+
+    void fft(std::vector<std::complex<double>>& a)
+    {
+        const std::size_t n = a.size();
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+            {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j)
+            {
+                std::swap(a[i], a[j]);
+            }
+        }
+        for (std::size_t length = 2; length <= n; length <<= 1)
+        {
+            const double angle = -2 * std::numbers::pi / double(length);
+            const std::complex<double> step(std::cos(angle), std::sin(angle));
+            for (std::size_t i = 0; i < n; i += length)
+            {
+                std::complex<double> w(1);
+                for (std::size_t j = 0; j < length / 2; ++j)
+                {
+                    const auto u = a[i + j];
+                    const auto v = a[i + j + length / 2] * w;
+                    a[i + j] = u + v;
+                    a[i + j + length / 2] = u - v;
+                    w *= step;
+                }
+            }
+        }
+    }
+
+    // Non-harmonic power from 30 Hz to 20 kHz relative to the harmonics',
+    // over the last 65536 samples of `y`
+    double aliasDb(const std::vector<float>& y, double f0)
+    {
+        constexpr std::size_t n = 65536;
+        std::vector<std::complex<double>> a(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double hann = 0.5 - 0.5 * std::cos(2 * std::numbers::pi * double(i) / n);
+            a[i] = y[y.size() - n + i] * hann;
+        }
+        fft(a);
+
+        double harmonics = 0, aliases = 0;
+        for (std::size_t k = 1; k < n / 2; ++k)
+        {
+            const double f = double(k) * sample_rate / n;
+            if (f < 30 || f > 20000)
+            {
+                continue;
+            }
+            const double m = f / f0;
+            const bool harmonic = std::fabs(m - std::round(m)) * f0 < 6 * sample_rate / n;
+            (harmonic ? harmonics : aliases) += std::norm(a[k]);
+        }
+        return test::db(aliases / harmonics);
+    }
+
+    // The fuzz as FuzzStage runs it, in blocks
+    void render(const Setting& setting, const std::vector<float>& x, std::vector<float>& y)
+    {
+        Fuzz fuzz;
+        fuzz.SetShaper(setting.shaper);
+        fuzz.SetOversampling(setting.ratio);
+        fuzz.SetIntensity(drive);
+        Oversampler oversampler(setting.ratio);
+        std::array<float, block * Oversampler::max_ratio> buffer;
+        for (std::size_t i = 0; i + block <= x.size(); i += block)
+        {
+            oversampler.upsample(&x[i], block, buffer.data());
+            fuzz.Process(buffer.data(), buffer.data(), block * oversampler.ratio());
+            oversampler.downsample(buffer.data(), block, &y[i]);
+        }
+    }
+
+    Aliasing measure(const Setting& setting)
+    {
+        const float gain = amplitude * (1.0f + drive * 19.0f);
+        std::vector<float> x(2 * std::size_t(sample_rate)), y(x.size());
+        Aliasing result;
+        for (const float f0 : tones)
+        {
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                x[i] = gain * float(std::sin(2 * std::numbers::pi * f0 * double(i) / sample_rate));
+            }
+            render(setting, x, y);
+            const double a = aliasDb(y, f0);
+            result.worst = std::max(result.worst, a);
+            result.mean += a / double(tones.size());
+        }
+        std::printf("         %-18s worst %6.1f dB, mean %6.1f dB\n", setting.name, result.worst, result.mean);
+        return result;
+    }
+}
+
+int main()
+{
+    antiderivatives();
+
+    const auto tanh1 = measure({"tanh 1x", FuzzShaper::TANH, 1});
+    const auto tanh4 = measure({"tanh 4x (default)", FuzzShaper::TANH, 4});
+    const auto adaa1_1 = measure({"ADAA1 1x", FuzzShaper::ADAA1, 1});
+    const auto adaa1_2 = measure({"ADAA1 2x", FuzzShaper::ADAA1, 2});
+    const auto adaa2_1 = measure({"ADAA2 1x", FuzzShaper::ADAA2, 1});
+    const auto adaa2_2 = measure({"ADAA2 2x", FuzzShaper::ADAA2, 2});
+
+    test::check(adaa1_1.worst < tanh1.worst - 5 && adaa2_1.worst < tanh1.worst - 5,
+                "at 1x, ADAA aliases at least 5 dB less than tanh: worst %.1f and %.1f dB against %.1f dB",
+                adaa1_1.worst, adaa2_1.worst, tanh1.worst);
+    test::check(adaa2_1.mean < tanh4.mean + 1.5,
+                "ADAA2 at 1x within 1.5 dB of tanh at 4x on average: %.1f dB against %.1f dB",
+                adaa2_1.mean, tanh4.mean);
+    test::check(adaa1_2.worst < tanh4.worst && adaa1_2.mean < tanh4.mean,
+                "ADAA1 at 2x aliases less than tanh at 4x: worst %.1f against %.1f dB, mean %.1f against %.1f dB",
+                adaa1_2.worst, tanh4.worst, adaa1_2.mean, tanh4.mean);
+    test::check(adaa2_2.worst < adaa1_2.worst && adaa2_2.mean < adaa1_2.mean,
+                "ADAA2 at 2x aliases less than ADAA1 at 2x: worst %.1f against %.1f dB, mean %.1f against %.1f dB",
+                adaa2_2.worst, adaa1_2.worst, adaa2_2.mean, adaa1_2.mean);
+
+    return test::result();
+}
@@ -0,0 +1,243 @@
+// The Fuzz class against the Fuzz namespace it replaced, which kept its
+// filter and gate state in function-local statics: the same output for
+// every type, per sample and in blocks, and two voices that don't affect
+// each other
+
+#include "Test.h"
+
+#include "buzzbox_hothouse.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    constexpr double fuzz_rate = 48000.0 * Fuzz::design_oversampling;
+    constexpr float intensity = 0.5f;
+
+    // As it was in buzzbox_hothouse.h. A template so each instantiation has
+    // its own statics, which lets each run start from rest.
+    namespace Previous
+    {
+        inline float softClipping(float input, float gain)
+        {
+            return std::tanh(input * gain);
+        }
+
+        inline float asymmetricClip(float input, float intensity)
+        {
+            const float pos_threshold = 0.8f;
+            const float neg_threshold = 1.0f;
+
+            if (input > 0.0f)
+            {
+                return softClipping(input, intensity) * pos_threshold;
+            }
+            else
+            {
+                return softClipping(input, intensity) * neg_threshold;
+            }
+        }
+
+        template <int Voice>
+        float fuzzEffect(float input, float intensity, FuzzType type)
+        {
+            static float dc_blocker_x1 = 0.0f;
+            static float dc_blocker_y1 = 0.0f;
+            static float gate_envelope = 0.0f;
+            static float pre_emphasis_state = 0.0f;
+
+            float fuzzed = input;
+
+            if (type == FuzzType::AGGRESSIVE)
+            {
+                const float emphasis_coeff = 0.7f;
+                float pre_emphasized = input + (input - pre_emphasis_state) * emphasis_coeff;
+                pre_emphasis_state = input;
+                fuzzed = pre_emphasized;
+            }
+
+            if (type == FuzzType::AGGRESSIVE)
+            {
+                fuzzed = asymmetricClip(fuzzed, intensity);
+            }
+            else
+            {
+                fuzzed = softClipping(fuzzed, intensity);
+            }
+
+            if (type == FuzzType::AGGRESSIVE)
+            {
+                fuzzed += 0.03f * (input * input);
+                fuzzed += 0.012f * (input * input * input * input);
+                fuzzed += 0.015f * (input * input * input);
+            }
+            else
+            {
+                fuzzed += 0.02f * (input * input) + 0.008f * (input * input * input * input);
+            }
+
+            const float dynamicIntensity = intensity * (1.0f + 0.5f * std::abs(input));
+            fuzzed = softClipping(fuzzed, dynamicIntensity);
+
+            const float dc_coeff = 0.997f;
+            float dc_blocked = fuzzed - dc_blocker_x1 + dc_coeff * dc_blocker_y1;
+            dc_blocker_x1 = fuzzed;
+            dc_blocker_y1 = dc_blocked;
+
+            if (type == FuzzType::AGGRESSIVE)
+            {
+                static float de_emphasis_state = 0.0f;
+                const float de_emphasis_coeff = 0.3f;
+                de_emphasis_state = de_emphasis_state + de_emphasis_coeff * (dc_blocked - de_emphasis_state);
+                dc_blocked = de_emphasis_state;
+            }
+
+            if (type == FuzzType::CLEAN)
+            {
+                return dc_blocked;
+            }
+            else
+            {
+                const float gate_threshold = 0.03f;
+                const float gate_attack = 0.95f;
+                const float gate_release = 0.01f;
+
+                float input_level = std::abs(input);
+
+                if (input_level > gate_threshold)
+                {
+                    gate_envelope += gate_attack * (1.0f - gate_envelope);
+                }
+                else
+                {
+                    gate_envelope += gate_release * (0.0f - gate_envelope);
+                }
+
+                return dc_blocked * gate_envelope;
+            }
+        }
+
+        template <int Voice>
+        float process(float sample, FuzzType type, float intensity)
+        {
+            return fuzzEffect<Voice>(sample, intensity * 10.0f, type);
+        }
+
+        template <int Voice>
+        std::vector<float> run(const std::vector<float>& x, FuzzType type)
+        {
+            std::vector<float> y(x.size());
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                y[i] = process<Voice>(x[i], type, intensity);
+            }
+            return y;
+        }
+    }
+
+    const char* name(FuzzType type)
+    {
+        switch (type)
+        {
+            case FuzzType::CLEAN: return "CLEAN";
+            case FuzzType::GATED: return "GATED";
+            case FuzzType::AGGRESSIVE: return "AGGRESSIVE";
+        }
+        return "?";
+    }
+
+    // Ahead of the fuzz the signal is boosted by up to 20x; a DI corpus at
+    // 4x the sample rate, boosted and with quiet gaps for the gate
+    std::vector<float> input(float gain, int notes)
+    {
+        auto x = test::diCorpus(fuzz_rate, notes);
+        for (auto& s : x)
+        {
+            s *= gain;
+        }
+        return x;
+    }
+
+    std::size_t mismatches(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            count += (a[i] != b[i]) ? 1 : 0;
+        }
+        return count;
+    }
+
+    template <int Voice>
+    void matches(FuzzType type, const std::vector<float>& x)
+    {
+        const auto want = Previous::run<Voice>(x, type);
+
+        Fuzz fuzz;
+        fuzz.Init(type);
+        fuzz.SetIntensity(intensity);
+        std::vector<float> y(x.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            y[i] = fuzz.Process(x[i]);
+        }
+        test::check(mismatches(y, want) == 0, "%s: Process(sample) == previous fuzzEffect(): %zu of %zu samples differ",
+                    name(type), mismatches(y, want), x.size());
+
+        // Blocks of the oversampled callback's sizes, and odd ones, and
+        // SetOversampling() at the design rate leaving the coefficients alone
+        fuzz.Init(type);
+        fuzz.SetOversampling(Fuzz::design_oversampling);
+        std::size_t i = 0;
+        for (const std::size_t n : {4, 1, 1024, 7, 256, 33})
+        {
+            fuzz.Process(&x[i], &y[i], n);
+            i += n;
+        }
+        fuzz.Process(&x[i], &y[i], x.size() - i);
+        test::check(mismatches(y, want) == 0, "%s: Process(block) == previous fuzzEffect(): %zu of %zu samples differ",
+                    name(type), mismatches(y, want), x.size());
+    }
+
+    // Two voices on different signals, interleaved block by block, each
+    // against the previous fuzz run on its signal alone
+    void voices(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        const auto want_a = Previous::run<10>(a, FuzzType::AGGRESSIVE);
+        const auto want_b = Previous::run<11>(b, FuzzType::AGGRESSIVE);
+
+        Fuzz fuzz_a, fuzz_b;
+        fuzz_a.SetIntensity(intensity);
+        fuzz_b.SetIntensity(intensity);
+        std::vector<float> y_a(a.size()), y_b(b.size());
+        constexpr std::size_t block = 256 * Fuzz::design_oversampling;
+        for (std::size_t i = 0; i + block <= a.size(); i += block)
+        {
+            fuzz_a.Process(&a[i], &y_a[i], block);
+            fuzz_b.Process(&b[i], &y_b[i], block);
+        }
+        const std::size_t tail = a.size() / block * block;
+        fuzz_a.Process(&a[tail], &y_a[tail], a.size() - tail);
+        fuzz_b.Process(&b[tail], &y_b[tail], b.size() - tail);
+
+        test::check(mismatches(y_a, want_a) == 0 && mismatches(y_b, want_b) == 0,
+                    "two voices side by side each match the previous fuzz alone: %zu and %zu samples differ",
+                    mismatches(y_a, want_a), mismatches(y_b, want_b));
+    }
+}
+
+int main()
+{
+    const auto x = input(10.0f, 6);
+
+    matches<0>(FuzzType::CLEAN, x);
+    matches<1>(FuzzType::GATED, x);
+    matches<2>(FuzzType::AGGRESSIVE, x);
+
+    auto y = input(4.0f, 6);
+    std::reverse(y.begin(), y.end());
+    voices(x, y);
+
+    return test::result();
+}
@@ -0,0 +1,119 @@
+// Cost of the firmware's AudioCallback between phrases, with the noise gate
+// at its default threshold and effectively off, for each routing that it
+// gates: plucked notes separated by 2 s of -70 dBFS hiss, timed per block
+
+#include "Bench.h"
+
+#include "Firmware.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 48000;
+    constexpr std::size_t block = audio_block_size;
+    constexpr std::size_t phrase = 3 * std::size_t(sample_rate);
+    constexpr std::size_t note = std::size_t(sample_rate);
+    constexpr int phrases = 4;
+    constexpr int runs = 3;
+
+    std::vector<float> input()
+    {
+        std::vector<float> x(phrases * phrase);
+        std::uint32_t r = 11;
+        const float hiss = std::pow(10.0f, -70.0f / 20.0f) * std::sqrt(3.0f);
+        for (std::size_t n = 0; n < x.size(); ++n)
+        {
+            r = r * 1664525u + 1013904223u;
+            const float noise = (float(r >> 8) / 8388608.0f - 1.0f) * hiss;
+            const std::size_t t = n % phrase;
+            float pluck = 0;
+            if (t < note)
+            {
+                const float time = float(t) / sample_rate;
+                const float phase = 2 * std::numbers::pi_v<float> * 110 * time;
+                pluck = 0.3f * std::exp(-4 * time) * (std::sin(phase) + 0.5f * std::sin(2 * phase + 1));
+            }
+            x[n] = pluck + noise;
+        }
+        return x;
+    }
+
+    struct Cost
+    {
+        double note = 0;
+        double gap = 0;
+    };
+
+    // Per sample, in the notes and in the gaps from 0.5 s after each note,
+    // once the gate has closed; the fastest of several runs for each block
+    Cost time(const std::vector<float>& x, bool fuzz, bool autowah, bool octave, bool gated)
+    {
+        const std::size_t blocks = x.size() / block;
+        std::vector<std::uint64_t> ticks(blocks, ~std::uint64_t(0));
+        std::vector<float> y(block), other(block);
+        for (int run = 0; run < runs; ++run)
+        {
+            host::toggles = {1, (autowah && octave) ? 0 : octave ? 2 : 1, 1};
+            host::start();
+            fuzz_stage.reset();
+            multirate.reset();
+            chain_idle = false;
+            noise_gate.SetThreshold(gated ? NOISE_GATE_DB : -200.0f);
+            fuzz_enabled = fuzz;
+            autowah_enabled = autowah;
+            octave_enabled = octave;
+
+            for (std::size_t b = 0; b < blocks; ++b)
+            {
+                const float* in[1] = {&x[b * block]};
+                float* out[2] = {y.data(), other.data()};
+                const std::uint64_t start = bench::ticks();
+                AudioCallback(in, out, block);
+                ticks[b] = std::min(ticks[b], bench::ticks() - start);
+            }
+            bench::sink = y[0];
+        }
+
+        Cost cost;
+        std::size_t notes = 0, gaps = 0;
+        for (std::size_t b = 0; b < blocks; ++b)
+        {
+            const std::size_t at = (b * block) % phrase;
+            if (at + block <= note)
+            {
+                cost.note += double(ticks[b]);
+                notes += block;
+            }
+            else if (at >= note + std::size_t(sample_rate) / 2 && at + block <= phrase)
+            {
+                cost.gap += double(ticks[b]);
+                gaps += block;
+            }
+        }
+        cost.note /= double(notes);
+        cost.gap /= double(gaps);
+        return cost;
+    }
+}
+
+int main()
+{
+    const auto x = input();
+
+    std::printf("AudioCallback, per sample, %zu-sample blocks\n", block);
+    for (const auto& [fuzz, autowah, octave, name] : {std::tuple{true, false, false, "fuzz"},
+                                                      std::tuple{false, false, true, "octave"},
+                                                      std::tuple{true, false, true, "fuzz and octave"},
+                                                      std::tuple{true, true, true, "all effects"}})
+    {
+        const Cost gated = time(x, fuzz, autowah, octave, true);
+        const Cost ungated = time(x, fuzz, autowah, octave, false);
+        std::printf("  %-16s notes %6.1f %s; between phrases %6.1f %s gated, %6.1f %s ungated\n", name,
+                    gated.note, bench::unit(), gated.gap, bench::unit(), ungated.gap, bench::unit());
+    }
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+// NoiseGate on its own (threshold, hysteresis, hold and release), and in the
+// firmware's AudioCallback: with only the autowah or no effects on, quiet
+// playing passes exactly as it would ungated, and with the fuzz or octave
+// on, the hiss between phrases is silenced and the chain skipped
+//
+// The input is plucked notes separated by 2 s of -70 dBFS hiss.
+
+#include "Test.h"
+
+#include "Firmware.h"
+
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_rate = 48000;
+    constexpr std::size_t block = audio_block_size;
+    constexpr std::size_t phrase = 3 * std::size_t(sample_rate);
+    constexpr std::size_t note = std::size_t(sample_rate);
+    constexpr int phrases = 3;
+
+    float rms(const float* x, std::size_t count)
+    {
+        double sum = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sum += double(x[i]) * x[i];
+        }
+        return float(std::sqrt(sum / double(count)));
+    }
+
+    // A 1 kHz tone at `db` dBFS into a gate, returning the gain after `count`
+    // samples
+    float gainAfter(NoiseGate& gate, float db, std::size_t count)
+    {
+        const float amplitude = std::pow(10.0f, db / 20.0f) * std::sqrt(2.0f);
+        float gain = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            gain = gate.Process(amplitude * std::sin(2 * std::numbers::pi_v<float> * 1000 * float(i) / sample_rate));
+        }
+        return gain;
+    }
+
+    void gate()
+    {
+        NoiseGate gate;
+        gate.Init(sample_rate);
+        gate.SetThreshold(-60.0f);
+
+        const float opened = gainAfter(gate, -54.0f, 96);
+        test::check(opened == 1.0f, "opens within 2ms 6dB over the threshold: gain %.3f", opened);
+
+        const float held = gainAfter(gate, -63.0f, 24000);
+        test::check(held == 1.0f, "stays open 3dB under the threshold, above the closing level: gain %.3f", held);
+
+        gate.Reset();
+        const float shut = gainAfter(gate, -63.0f, 24000);
+        test::check(shut == 0.0f, "doesn't open from closed 3dB under the threshold: gain %.3f", shut);
+
+        gainAfter(gate, -54.0f, 4800);
+        const float hold = gainAfter(gate, -90.0f, 48 * 50);
+        test::check(hold == 1.0f, "holds for 50ms after the input drops: gain %.3f", hold);
+
+        const float release = gainAfter(gate, -90.0f, 48 * 60);
+        test::check(release > 0.0f && release < 1.0f, "releases over 100ms: gain %.3f 60ms later", release);
+
+        gainAfter(gate, -90.0f, 48 * 100);
+        std::vector<float> quiet(block, 1e-6f), gain(block);
+        const bool closed = gate.Process(quiet.data(), gain.data(), block);
+        test::check(closed && !gate.IsOpen(), "fully closed 210ms after the input drops");
+    }
+
+    std::vector<float> input()
+    {
+        std::vector<float> x(phrases * phrase);
+        std::uint32_t r = 11;
+        const float hiss = std::pow(10.0f, -70.0f / 20.0f) * std::sqrt(3.0f);  // -70 dBFS rms
+        for (std::size_t n = 0; n < x.size(); ++n)
+        {
+            r = r * 1664525u + 1013904223u;
+            const float noise = (float(r >> 8) / 8388608.0f - 1.0f) * hiss;
+            const std::size_t t = n % phrase;
+            float pluck = 0;
+            if (t < note)
+            {
+                const float time = float(t) / sample_rate;
+                const float phase = 2 * std::numbers::pi_v<float> * 110 * time;
+                pluck = 0.3f * std::exp(-4 * time) * (std::sin(phase) + 0.5f * std::sin(2 * phase + 1));
+            }
+            x[n] = pluck + noise;
+        }
+        return x;
+    }
+
+    // The pedal from power-up with the given effects, mix all wet, and the
+    // noise gate at its default threshold or effectively off
+    struct Render
+    {
+        std::vector<float> y;
+        std::size_t idle_blocks = 0;
+    };
+
+    Render render(const std::vector<float>& x, bool fuzz, bool autowah, bool octave, bool gated)
+    {
+        // Switch 2 picks what footswitch 2 turns on, and the firmware
+        // applies it to the effect flags on its first control update
+        host::knobs = {0.5f, 1.0f, 0.5f, 0.5f, 0.5f, 0.5f};
+        host::toggles = {1, (autowah && octave) ? 0 : octave ? 2 : 1, 1};
+        host::start();
+        fuzz_stage.reset();
+        multirate.reset();
+        chain_idle = false;
+        noise_gate.SetThreshold(gated ? NOISE_GATE_DB : -200.0f);
+        fuzz_enabled = fuzz;
+        autowah_enabled = autowah;
+        octave_enabled = octave;
+
+        Render result;
+        result.y.resize(x.size());
+        std::vector<float> other(block);
+        for (std::size_t i = 0; i + block <= x.size(); i += block)
+        {
+            const float* in[1] = {&x[i]};
+            float* out[2] = {&result.y[i], other.data()};
+            AudioCallback(in, out, block);
+            result.idle_blocks += chain_idle ? 1 : 0;
+        }
+        return result;
+    }
+
+    // Output level in the gaps, from 1 s after each note's end, past the
+    // gate's release and the chain's tails
+    float gapDb(const std::vector<float>& y)
+    {
+        double sum = 0;
+        std::size_t count = 0;
+        for (int p = 0; p < phrases; ++p)
+        {
+            const std::size_t from = p * phrase + note + std::size_t(sample_rate);
+            const float level = rms(&y[from], phrase - note - std::size_t(sample_rate));
+            sum += double(level) * level;
+            ++count;
+        }
+        return 20 * std::log10(float(std::sqrt(sum / double(count))) + 1e-30f);
+    }
+
+    void passThrough(const std::vector<float>& x)
+    {
+        for (const bool autowah : {false, true})
+        {
+            const auto gated = render(x, false, autowah, false, true);
+            const auto ungated = render(x, false, autowah, false, false);
+            test::check(gated.y == ungated.y && gated.idle_blocks == 0,
+                        "%s: output == ungated, hiss passes at %.1f dBFS", autowah ? "autowah only" : "no effects",
+                        gapDb(gated.y));
+        }
+    }
+
+    void silenced(const std::vector<float>& x)
+    {
+        for (const auto& [fuzz, autowah, octave, name] : {std::tuple{true, false, false, "fuzz"},
+                                                          std::tuple{false, false, true, "octave"},
+                                                          std::tuple{true, true, true, "all effects"}})
+        {
+            const auto gated = render(x, fuzz, autowah, octave, true);
+            const auto ungated = render(x, fuzz, autowah, octave, false);
+            const float gap = gapDb(gated.y);
+            const std::size_t gap_blocks = phrases * (phrase - note) / block;
+            test::check(gap < -120.0f && gated.idle_blocks > gap_blocks / 2,
+                        "%s: gaps at %.1f dBFS (%.1f dBFS ungated), chain skipped for %zu of ~%zu gap blocks",
+                        name, gap, gapDb(ungated.y), gated.idle_blocks, gap_blocks);
+        }
+    }
+}
+
+int main()
+{
+    gate();
+
+    const auto x = input();
+    passThrough(x);
+    silenced(x);
+
+    return test::result();
+}
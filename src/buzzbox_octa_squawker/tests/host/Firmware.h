@@ -0,0 +1,64 @@
+// The buzzbox firmware as part of a host program. Its main() becomes
+// firmware_main(); start() runs the pedal's setup up to the point where it
+// starts the audio, and the program then calls AudioCallback() itself. The
+// knobs and switches read host::knobs and host::toggles.
+#pragma once
+
+#include <array>
+
+namespace host
+{
+    inline std::array<float, 6> knobs{0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+    inline std::array<int, 3> toggles{1, 1, 1};
+
+    // Thrown by Hothouse::StartAudio() to leave main() before its idle loop
+    struct AudioStarted
+    {
+    };
+}
+
+#define main firmware_main
+#include "buzzbox_hothouse.cpp"
+#undef main
+
+namespace clevelandmusicco
+{
+    void Hothouse::Init(bool) {}
+    void Hothouse::SetAudioBlockSize(size_t) {}
+    float Hothouse::AudioSampleRate() { return 48000.0f; }
+    void Hothouse::StartAdc() {}
+    void Hothouse::StopAdc() {}
+    void Hothouse::StopAudio() {}
+    void Hothouse::ProcessAnalogControls() {}
+    void Hothouse::ProcessDigitalControls() {}
+
+    void Hothouse::StartAudio(AudioHandle::AudioCallback)
+    {
+        throw host::AudioStarted();
+    }
+
+    float Hothouse::GetKnobValue(Knob k)
+    {
+        return host::knobs[k];
+    }
+
+    Hothouse::ToggleswitchPosition Hothouse::GetToggleswitchPosition(Toggleswitch tsw)
+    {
+        return ToggleswitchPosition(host::toggles[tsw]);
+    }
+}
+
+namespace host
+{
+    // The firmware's setup, as main() does it on the pedal
+    inline void start()
+    {
+        try
+        {
+            firmware_main();
+        }
+        catch (const AudioStarted&)
+        {
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// Host stand-in for libDaisy: the types hothouse.h and the firmware use.
+// The hardware does nothing; the Hothouse functions are in Firmware.h.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace daisy
+{
+    struct Pin
+    {
+    };
+
+    struct AdcChannelConfig
+    {
+    };
+
+    struct AnalogControl
+    {
+    };
+
+    struct AdcHandle
+    {
+        uint16_t* GetPtr(uint8_t) { return nullptr; }
+    };
+
+    struct SaiHandle
+    {
+        struct Config
+        {
+            enum class SampleRate
+            {
+                SAI_48KHZ
+            };
+        };
+    };
+
+    struct AudioHandle
+    {
+        typedef const float* const* InputBuffer;
+        typedef float** OutputBuffer;
+        typedef void (*AudioCallback)(InputBuffer in, OutputBuffer out, size_t size);
+        typedef const float* InterleavingInputBuffer;
+        typedef float* InterleavingOutputBuffer;
+        typedef void (*InterleavingAudioCallback)(InterleavingInputBuffer in, InterleavingOutputBuffer out,
+                                                  size_t size);
+    };
+
+    // Footswitches are never pressed; the tests set the effect flags directly
+    struct Switch
+    {
+        bool RisingEdge() const { return false; }
+        float TimeHeldMs() const { return 0; }
+    };
+
+    struct Led
+    {
+        void Init(Pin, bool) {}
+        void Set(float) {}
+        void Update() {}
+    };
+
+    struct DaisySeed
+    {
+        Pin GetPin(uint8_t) { return {}; }
+        AdcHandle adc;
+    };
+
+    struct System
+    {
+        static void Delay(uint32_t) {}
+        static void ResetToBootloader() {}
+    };
+}
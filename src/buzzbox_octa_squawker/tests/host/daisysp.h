@@ -0,0 +1,208 @@
+// Host stand-in for DaisySP: the modules the buzzbox code uses, following
+// DaisySP's own code so the host output matches the pedal's
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace daisysp
+{
+#ifndef PI_F
+#define PI_F 3.1415927410125732421875f
+#endif
+#define TWOPI_F (2.0f * PI_F)
+
+    inline float fclamp(float in, float min, float max)
+    {
+        return std::min(std::max(in, min), max);
+    }
+
+    enum
+    {
+        ADSR_SEG_IDLE = 0,
+        ADSR_SEG_ATTACK = 1,
+        ADSR_SEG_DECAY = 2,
+        ADSR_SEG_RELEASE = 4
+    };
+
+    class Adsr
+    {
+    public:
+        void Init(float sample_rate, int block_size = 1)
+        {
+            sample_rate_ = sample_rate / block_size;
+            attack_shape_ = -1.0f;
+            attack_target_ = 0.0f;
+            attack_time_ = -1.0f;
+            decay_time_ = -1.0f;
+            release_time_ = -1.0f;
+            sus_level_ = 0.7f;
+            x_ = 0.0f;
+            gate_ = false;
+            mode_ = ADSR_SEG_IDLE;
+            SetTime(ADSR_SEG_ATTACK, 0.1f);
+            SetTime(ADSR_SEG_DECAY, 0.1f);
+            SetTime(ADSR_SEG_RELEASE, 0.1f);
+        }
+
+        void SetTime(int seg, float time)
+        {
+            switch (seg)
+            {
+                case ADSR_SEG_ATTACK: SetAttackTime(time, 0.0f); break;
+                case ADSR_SEG_DECAY: SetTimeConstant(time, decay_time_, decay_d0_); break;
+                case ADSR_SEG_RELEASE: SetTimeConstant(time, release_time_, release_d0_); break;
+                default: break;
+            }
+        }
+
+        void SetAttackTime(float time, float shape = 0.0f)
+        {
+            if (time == attack_time_ && shape == attack_shape_)
+            {
+                return;
+            }
+            attack_time_ = time;
+            attack_shape_ = shape;
+            if (time > 0.0f)
+            {
+                attack_target_ = 9.0f * std::pow(shape, 10.0f) + 0.3f * shape + 1.01f;
+                const float log_target = std::log(1.0f - (1.0f / attack_target_));
+                attack_d0_ = 1.0f - std::exp(log_target / (time * sample_rate_));
+            }
+            else
+            {
+                attack_d0_ = 1.0f;
+            }
+        }
+
+        void SetDecayTime(float time) { SetTimeConstant(time, decay_time_, decay_d0_); }
+        void SetReleaseTime(float time) { SetTimeConstant(time, release_time_, release_d0_); }
+
+        void SetSustainLevel(float level)
+        {
+            sus_level_ = (level <= 0.0f) ? -0.01f : (level > 1.0f) ? 1.0f : level;
+        }
+
+        float Process(bool gate)
+        {
+            if (gate && !gate_)
+            {
+                mode_ = ADSR_SEG_ATTACK;
+            }
+            else if (!gate && gate_)
+            {
+                mode_ = ADSR_SEG_RELEASE;
+            }
+            gate_ = gate;
+
+            const float d0 = (mode_ == ADSR_SEG_DECAY)     ? decay_d0_
+                             : (mode_ == ADSR_SEG_RELEASE) ? release_d0_
+                                                           : attack_d0_;
+            const float target = (mode_ == ADSR_SEG_DECAY) ? sus_level_ : -0.01f;
+            float out = 0.0f;
+            switch (mode_)
+            {
+                case ADSR_SEG_ATTACK:
+                    x_ += d0 * (attack_target_ - x_);
+                    out = x_;
+                    if (out > 1.0f)
+                    {
+                        x_ = out = 1.0f;
+                        mode_ = ADSR_SEG_DECAY;
+                    }
+                    break;
+                case ADSR_SEG_DECAY:
+                case ADSR_SEG_RELEASE:
+                    x_ += d0 * (target - x_);
+                    out = x_;
+                    if (out < 0.0f)
+                    {
+                        x_ = out = 0.0f;
+                        mode_ = ADSR_SEG_IDLE;
+                    }
+                    break;
+                default: break;
+            }
+            return out;
+        }
+
+    private:
+        void SetTimeConstant(float time, float& stored, float& coeff)
+        {
+            if (time == stored)
+            {
+                return;
+            }
+            stored = time;
+            coeff = (time > 0.0f) ? 1.0f - std::exp(-1.0f / (time * sample_rate_)) : 1.0f;
+        }
+
+        float sus_level_, x_, attack_shape_, attack_target_;
+        float attack_time_, decay_time_, release_time_;
+        float attack_d0_, decay_d0_, release_d0_;
+        int sample_rate_;
+        int mode_;
+        bool gate_;
+    };
+
+    // One-pole highpass
+    class ATone
+    {
+    public:
+        void Init(float sample_rate)
+        {
+            prevout_ = 0.0f;
+            previn_ = 0.0f;
+            sample_rate_ = sample_rate;
+            float freq = 1000.0f;
+            SetFreq(freq);
+        }
+
+        float Process(float& in)
+        {
+            const float out = c2_ * (prevout_ + in - previn_);
+            prevout_ = out;
+            previn_ = in;
+            return out;
+        }
+
+        void SetFreq(float& freq)
+        {
+            const float b = 2.0f - std::cos(TWOPI_F * freq / sample_rate_);
+            c2_ = b - std::sqrt(b * b - 1.0f);
+        }
+
+    private:
+        float prevout_, previn_, c2_, sample_rate_;
+    };
+
+    // One-pole lowpass
+    class Tone
+    {
+    public:
+        void Init(float sample_rate)
+        {
+            prevout_ = 0.0f;
+            sample_rate_ = sample_rate;
+            SetFreq(100.0f);
+        }
+
+        float Process(float& in)
+        {
+            const float out = c1_ * in + c2_ * prevout_;
+            prevout_ = out;
+            return out;
+        }
+
+        void SetFreq(float freq)
+        {
+            const float b = 2.0f - std::cos(TWOPI_F * freq / sample_rate_);
+            c2_ = b - std::sqrt(b * b - 1.0f);
+            c1_ = 1.0f - c2_;
+        }
+
+    private:
+        float prevout_, c1_, c2_, sample_rate_;
+    };
+}